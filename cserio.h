@@ -10,6 +10,23 @@
 #ifndef CSERIO_H
 #define CSERIO_H
 
+/* POSIX routines used by the file backends require feature test macros
+ * to be defined before the first system header is included, so the
+ * implementation has to be included first or built through cserio.c.
+ * On Linux O_DIRECT is only exposed under _GNU_SOURCE. */
+#if defined(CSERIO_IMPLEMENTATION) && !defined(_POSIX_C_SOURCE) && !defined(_GNU_SOURCE)
+#if defined(__linux__)
+#define _GNU_SOURCE
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+#endif
+
+/* File offsets are 64-bit even where long and off_t default to 32. */
+#if defined(CSERIO_IMPLEMENTATION) && !defined(_FILE_OFFSET_BITS)
+#define _FILE_OFFSET_BITS 64
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -49,6 +66,10 @@ extern "C" {
 
 #define WRITE_ON_READONLY                   131
 
+#define NOT_SUPPORTED                       141
+
+#define SIZE_OVERFLOW                       151
+
 /*-------------------- File Access Errors --------------------*/
 
 #define NULL_PATH                           201
@@ -57,6 +78,7 @@ extern "C" {
 
 #define FILE_OPEN_ERROR                     211
 #define FILE_CLOSE_ERROR                    212
+#define FILE_FLUSH_ERROR                    213
 
 #define INVALID_STRUCTURE                   222
 
@@ -71,6 +93,7 @@ extern "C" {
 #define INVALID_FRAME_SIZE                  403
 
 #define IMAGE_WRITE_WARN                    411
+#define RESERVE_ERROR                       412
 
 /*-------------------- Trailer Routine Errors --------------------*/
 
@@ -80,6 +103,17 @@ extern "C" {
 
 #define TRAILER_CLOSE_WARN                  521
 
+#define JOURNAL_WRITE_ERROR                 531
+
+/*-------------------- Asynchronous Routine Errors --------------------*/
+
+#define ASYNC_QUEUE_FULL                    601
+#define INVALID_ASYNC_DEPTH                 602
+
+#define ASYNC_INIT_ERROR                    611
+
+#define CALLBACK_ABORTED                    621
+
 
 /*------------------------------------------------------------------*/
 /* CSERIO Constants */ 
@@ -89,6 +123,22 @@ extern "C" {
 
 #define READONLY                            0
 #define READWRITE                           1
+#define READFOLLOW                          2
+#define READSALVAGE                         3
+
+/*-------------------- SER Access Patterns --------------------*/
+
+#define ACCESS_NORMAL                       0
+#define ACCESS_SEQUENTIAL                   1
+#define ACCESS_RANDOM                       2
+#define ACCESS_ONCE                         3
+
+/*-------------------- SER Commit Policies --------------------*/
+
+#define COMMIT_EVERY_FRAME                  0
+#define COMMIT_FRAMES                       1
+#define COMMIT_INTERVAL                     2
+#define COMMIT_ON_FLUSH                     3
 
 /*-------------------- Header Symbolic Constants --------------------*/
 
@@ -165,6 +215,62 @@ extern "C" {
  */
 typedef struct serfile serfile;
 
+/*  serbackend describes a user supplied storage layer for the
+ *  custom access routines. All callbacks receive context as their
+ *  first argument. Offsets are absolute 64-bit byte positions in the SER.
+ *
+ *  reader and sizer are required. writer is required for READWRITE
+ *  access. flusher, closer, and lender are optional and may be NULL.
+ *
+ *  reader  - Copy size bytes at offset into buffer, return bytes read.
+ *  writer  - Copy size bytes from data to offset, return bytes written.
+ *  sizer   - Return the current byte size of the SER.
+ *  flusher - Commit written data to storage, return 0 on success.
+ *  closer  - Release the storage, return 0 on success.
+ *  lender  - Return a pointer to size bytes at offset, or NULL.
+ */
+typedef struct serbackend {
+    void*       context;
+    size_t      (*reader)(void* context, void* buffer, size_t size, uint64_t offset);
+    size_t      (*writer)(void* context, const void* data, size_t size, uint64_t offset);
+    uint64_t    (*sizer)(void* context);
+    int         (*flusher)(void* context);
+    int         (*closer)(void* context);
+    const void* (*lender)(void* context, size_t size, uint64_t offset);
+} serbackend;
+
+/*  serinfo receives the metadata of a SER from ser_probe. The 
+ *  header fields mirror the on-disk header. The remaining fields
+ *  are derived from the header and the size of the file.
+ *
+ *  frame_byte_size - Bytes per frame, 0 if the header does not 
+ *                    describe an addressable frame.
+ *  file_size       - Byte size of the file.
+ *  has_trailer     - A complete time stamp trailer is present.
+ *  valid           - The file would be accepted by the open routines.
+ */
+typedef struct serinfo {
+    char            file_id[FILEID_LEN];
+    int32_t         lu_id;
+    int32_t         color_id;
+    int32_t         little_endian;
+    int32_t         image_width;
+    int32_t         image_height;
+    int32_t         pixel_depth_per_plane;
+    int32_t         frame_count;
+    char            observer[OBSERVER_LEN];
+    char            instrument[INSTRUMENT_LEN];
+    char            telescope[TELESCOPE_LEN];
+    int64_t         date_time;
+    int64_t         date_time_utc;
+
+    unsigned long   bytes_per_pixel;
+    unsigned long   frame_byte_size;
+    uint64_t        file_size;
+    bool            has_trailer;
+    bool            valid;
+} serinfo;
+
 
 /*-------------------- Core Routines --------------------*/
 
@@ -192,12 +298,73 @@ int ser_create_file(serfile** sptr, const char* path, int* status);
  *
  *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
  *  @param  path        (I)     - SER file path.
- *  @param  mode        (I)     - Access type (READONLY or READWRITE).
+ *  @param  mode        (I)     - Access type (READONLY, READWRITE,
+ *                                READFOLLOW, or READSALVAGE).
  *  @param  status      (IO)    - Error status.
  *  @return Error Status.
  */
 int ser_open_file(serfile** sptr, const char* path, int mode, int* status);
 
+/*  @brief  Opens existing SER file as a memory mapping.
+ *
+ *  The file is mapped into the address space and read/written
+ *  through the page cache rather than through stdio. In READWRITE
+ *  mode the mapping grows as frames are appended. Close with
+ *  ser_close_file.
+ *
+ *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
+ *  @param  path        (I)     - SER file path.
+ *  @param  mode        (I)     - Access type (READONLY, READWRITE,
+ *                                or READSALVAGE).
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_open_file_mapped(serfile** sptr, const char* path, int mode, int* status);
+
+/*  @brief  Opens existing SER file with positional IO.
+ *
+ *  The file is accessed through a raw descriptor using pread and
+ *  pwrite, so the handle has no shared file cursor and concurrent
+ *  ser_read_frame and ser_read_timestamp calls on it are safe. 
+ *  Close with ser_close_file.
+ *
+ *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
+ *  @param  path        (I)     - SER file path.
+ *  @param  mode        (I)     - Access type (READONLY, READWRITE,
+ *                                READFOLLOW, or READSALVAGE).
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_open_file_positional(serfile** sptr, const char* path, int mode, int* status);
+
+/*  @brief  Create a new SER file for direct IO capture.
+ *
+ *  Writes bypass the page cache (O_DIRECT, or F_NOCACHE on macOS).
+ *  Header, frame and trailer writes are gathered in an aligned
+ *  staging buffer and written out in whole blocks, so the 178 byte
+ *  header offset does not matter to the caller. Filesystems that
+ *  reject direct IO fall back to buffered writes. Close with
+ *  ser_close_file.
+ *
+ *  @param  sptr        (IO)    - Pointer to pointer of a serfile.
+ *  @param  path        (I)     - File path.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_create_file_direct(serfile** sptr, const char* path, int* status);
+
+/*  @brief  Opens existing SER file for direct IO capture.
+ *
+ *  The file is opened READWRITE so frames can be appended as with
+ *  ser_create_file_direct. Close with ser_close_file.
+ *
+ *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
+ *  @param  path        (I)     - SER file path.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_open_file_direct(serfile** sptr, const char* path, int* status);
+
 /*  @brief  Close SER file
  *
  *  Closes the serfile and frees the structure. Parameter sptr will
@@ -209,6 +376,56 @@ int ser_open_file(serfile** sptr, const char* path, int mode, int* status);
  */
 int ser_close_file(serfile* sptr, int* status);
 
+/*-------------------- Probe Routines --------------------*/
+
+/*  @brief  Read the metadata of a SER file without opening it.
+ *
+ *  Fills info with the header, frame geometry, file size, trailer
+ *  presence, and structural validity of the file using one stat
+ *  and one header read. Nothing is allocated and no serfile is
+ *  needed. A file that is not a valid SER is not an error, it is
+ *  reported through info->valid.
+ *
+ *  @param  path        (I)     - File path.
+ *  @param  info        (IO)    - Pointer to serinfo.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_probe(const char* path, serinfo* info, int* status);
+
+/*-------------------- Clone Routines --------------------*/
+
+/*  @brief  Create another read handle on an open SER file.
+ *
+ *  The clone gets its own file descriptor and reads with positional
+ *  IO, so a handle and its clones can each be used from a separate
+ *  thread. The parsed header is copied without any IO, and the time 
+ *  stamp trailer is loaded once and shared by reference between
+ *  the handle and all of its clones. Only READONLY handles backed 
+ *  by a file can be cloned, others fail with NOT_SUPPORTED. Each
+ *  clone is closed with ser_close_file, in any order.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile to clone.
+ *  @param  clone       (IO)    - Pointer to pointer of a serfile.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_clone_handle(serfile* sptr, serfile** clone, int* status);
+
+/*-------------------- Follow Routines --------------------*/
+
+/*  @brief  Pick up frames committed since the handle was opened.
+ *
+ *  Only handles opened in READFOLLOW mode can be refreshed, others
+ *  fail with NOT_SUPPORTED. Until the SER has frames the whole 
+ *  header is read again, after that only its frame count.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_refresh(serfile* sptr, int* status);
+
 /*-------------------- Header Routines --------------------*/
 
 /*  @brief  Returns number of records in the header
@@ -468,6 +685,36 @@ int ser_get_frame_byte_size(serfile* sptr, unsigned long* byte_size, int* status
  */
 int ser_read_frame(serfile* sptr, void* dest, size_t idx, int* status);
 
+/*  @brief  Read a contiguous range of image frames.
+ *
+ *  Frames first to first + count - 1 are read back to back into
+ *  dest with a single backend read. Ensure the dest buffer can
+ *  hold count whole frames.
+ *
+ *  @param  sptr    (I)   - Pointer to serfile.
+ *  @param  dest    (IO)  - Pointer to destination buffer.
+ *  @param  first   (I)   - Index of the first frame.
+ *  @param  count   (I)   - Number of frames to read.
+ *  @param  status  (IO)  - Error status. 
+ *  @return Error Status.
+ */
+int ser_read_frames(serfile* sptr, void* dest, size_t first, size_t count, int* status);
+
+/*  @brief  Borrow a pointer to the image frame at the index.
+ *
+ *  No data is copied, the pointer refers directly to the frame
+ *  inside the backing buffer or mapping. Only memory, view, and
+ *  mapped handles support this, file handles fail with NOT_SUPPORTED.
+ *  The pointer is invalidated by ser_append_frame and by closing.
+ *
+ *  @param  sptr    (I)   - Pointer to serfile.
+ *  @param  idx     (I)   - Index of the frame.
+ *  @param  out     (IO)  - Pointer to the borrowed frame pointer.
+ *  @param  status  (IO)  - Error status. 
+ *  @return Error Status.
+ */
+int ser_get_frame_ptr(serfile* sptr, size_t idx, const void** out, int* status);
+
 /*  @brief  Write image frame at the index.
  *
  *  The byte size of a whole frame is written from data.
@@ -482,9 +729,46 @@ int ser_read_frame(serfile* sptr, void* dest, size_t idx, int* status);
  */
 int ser_append_frame(serfile* sptr, const void* data, uint64_t timestamp, int* status);
 
+/*  @brief  Borrow the buffer the next appended frame is staged in.
+ *
+ *  Only direct IO handles support this, other handles fail with
+ *  NOT_SUPPORTED. Fill the buffer with a whole frame and pass it to
+ *  ser_append_frame, which then skips its copy. The buffer is aligned
+ *  staging memory owned by the handle and is invalidated by any other
+ *  write to the handle and by closing.
+ *
+ *  @param  sptr    (I)   - Pointer to serfile.
+ *  @param  buffer  (IO)  - Pointer to the borrowed buffer pointer.
+ *  @param  status  (IO)  - Error status. 
+ *  @return Error Status.
+ */
+int ser_get_append_buffer(serfile* sptr, void** buffer, int* status);
+
+/*  @brief  Preallocate storage for frames about to be appended.
+ *
+ *  Space for count more frames (and their timestamps when the SER
+ *  has a trailer) is reserved up front: disk blocks on file handles,
+ *  buffer capacity on memory handles, and room in the in-memory
+ *  timestamp array. count is in addition to the frames already in
+ *  the SER. The reported size of the SER does not change. Reserved
+ *  blocks left unused are given back when the file is closed. Views
+ *  and custom handles fail with NOT_SUPPORTED.
+ *
+ *  @param  sptr    (I)   - Pointer to serfile.
+ *  @param  count   (I)   - Number of frames to reserve space for.
+ *  @param  status  (IO)  - Error status. 
+ *  @return Error Status.
+ */
+int ser_reserve_frames(serfile* sptr, size_t count, int* status);
+
 /*-------------------- Trailer Routines --------------------*/
 
 /*  @brief  Read trailer time stamp at index.
+ *
+ *  Opening a SER does not read its trailer. Mapped and memory 
+ *  handles read time stamps in place; other handles load the whole
+ *  trailer on the first call.
+ *
  *  @param  sptr    (I)     - Pointer to serfile.
  *  @param  dest    (IO)    - Pointer to data buffer.
  *  @param  idx     (I)     - Index of time stamp.
@@ -494,863 +778,5452 @@ int ser_append_frame(serfile* sptr, const void* data, uint64_t timestamp, int* s
 int ser_read_timestamp(serfile* sptr, int64_t* dest, size_t idx, int* status);
 
 
-/*-------------------- Memory-Backed SER Access Routines --------------------*/
+/*-------------------- Access Hint Routines --------------------*/
 
-/*  @brief  Opens new in-memory SER file.
- *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
+/*  @brief  Declare how frames of the SER will be accessed.
+ *
+ *  The pattern is passed on to the kernel as file or mapping 
+ *  advice. ACCESS_ONCE additionally drops each frame from the 
+ *  page cache after it has been read. Handles without a file
+ *  descriptor accept the call and ignore it.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  pattern     (I)     - ACCESS_NORMAL, ACCESS_SEQUENTIAL,
+ *                                ACCESS_RANDOM, or ACCESS_ONCE.
  *  @param  status      (IO)    - Error status.
- *  @return Error status.
+ *  @return Error Status.
  */
-int ser_create_memory(serfile** sptr, int* status);
+int ser_set_access_pattern(serfile* sptr, int pattern, int* status);
 
-/*  @brief  Opens in-memory SER file.
+/*  @brief  Enable or disable the background frame prefetcher.
  *
- *  For when a SER file is located in memory. Note that the 
- *  data must persist so long as it is opened to the serfile.
- *  Read and write routines only operate within the range
- *  provided by size. 
+ *  After every ser_read_frame of frame N, a background thread 
+ *  has the kernel read frames N+1 to N+distance into the page
+ *  cache so that the IO overlaps with the caller's processing of
+ *  frame N. A distance of 0 stops the prefetcher. Only file 
+ *  handles on systems with posix_fadvise support prefetching,
+ *  other handles fail with NOT_SUPPORTED.
  *
- *  @param  sptr      (IO)  - Pointer to a pointer of a serfile.
- *  @param  data      (I)   - Pointer to data.
- *  @param  size      (I)   - Size of data view.
- *  @param  mode      (I)   - Access type (READONLY or READWRITE).
- *  @param  status    (IO)  - Error status.
- *  @return Error status.
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  distance    (I)     - Number of frames to read ahead.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
  */
-int ser_open_view(serfile** sptr, uint8_t* data, size_t size, int mode, int* status);
+int ser_set_prefetch(serfile* sptr, size_t distance, int* status);
 
-/*  @brief  Opens/Copies in-memory SER file.
+
+/*-------------------- Commit Routines --------------------*/
+
+/*  @brief  Choose when ser_append_frame updates the header.
  *
- *  Memory is allocated and managed by the serfile.
+ *  With COMMIT_EVERY_FRAME (the default) the frame count in the 
+ *  header is rewritten after every appended frame. COMMIT_FRAMES
+ *  rewrites it every value frames, COMMIT_INTERVAL at most every 
+ *  value milliseconds, and COMMIT_ON_FLUSH only in ser_flush and
+ *  on close. value is ignored by the other policies.
  *
- *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
- *  @param  data        (I)     - Pointer to data.
- *  @param  size        (I)     - Size to initially allocate / copy over.
- *  @param  mode        (I)     - Access type (READONLY or READWRITE).
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  policy      (I)     - Commit policy.
+ *  @param  value       (I)     - Frame count or interval in ms.
  *  @param  status      (IO)    - Error status.
  *  @return Error Status.
  */
-int ser_open_memory(serfile** sptr, const uint8_t* data, size_t size, int mode, int* status);
+int ser_set_commit_policy(serfile* sptr, int policy, size_t value, int* status);
 
-/*  @brief  Close in-memory SER file
+/*  @brief  Make everything appended so far durable.
  *
- *  Closes the serfile and frees the structure. Parameter sptr will
- *  be set to NULL.
+ *  The header frame count and the trailer are written for the
+ *  frames appended so far and the backend is flushed to storage,
+ *  so the SER is valid at this point should the process die.
  *
- *  @param  sptr        (IO)    - Pointer to a serfile.
+ *  @param  sptr        (I)     - Pointer to serfile.
  *  @param  status      (IO)    - Error status.
  *  @return Error Status.
  */
-int ser_close_memory(serfile* sptr, int* status);
+int ser_flush(serfile* sptr, int* status);
 
 
-/*------------------------------------------------------------------*/
-/* CSERIO Implementation */ 
-/*------------------------------------------------------------------*/
+/*-------------------- Journal Routines --------------------*/
 
-#if defined(CSERIO_IMPLEMENTATION)
+/*  @brief  Journal appended timestamps to a sidecar file.
+ *
+ *  Timestamps are otherwise written only when the trailer is, so 
+ *  a capture that dies before ser_flush or close loses all of
+ *  them. With a journal every appended timestamp is also written
+ *  to path, which is synced to storage every interval frames, so
+ *  at most interval timestamps are lost. Timestamps already held
+ *  by the handle are journaled first. A NULL path stops and 
+ *  removes the journal. A clean close removes it as well, once 
+ *  the trailer is on storage.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  path        (I)     - Path of the journal, or NULL.
+ *  @param  interval    (I)     - Frames between journal syncs.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_set_journal(serfile* sptr, const char* path, size_t interval, int* status);
+
+/*  @brief  Rebuild the header and trailer of an interrupted SER.
+ *
+ *  Without a journal the frames are those READSALVAGE finds, and
+ *  the trailer keeps the timestamps that survive in the file, 
+ *  lost ones are written as 0. With a journal the frames are 
+ *  those entirely in the file that also have a timestamp in the 
+ *  journal, and the trailer is rebuilt from it. Only the frame 
+ *  count and the tail of the file are rewritten, anything past 
+ *  the trailer is truncated. A valid SER is left untouched.
+ *
+ *  @param  path        (I)     - Path to the SER.
+ *  @param  journal     (I)     - Path to the journal, or NULL.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_repair_file(const char* path, const char* journal, int* status);
 
 
-/*-------------------- Structure Implementation --------------------*/
+/*-------------------- Capacity Routines --------------------*/
 
-/*  
- *  serfile implementation.
+/*  @brief  Release in-memory capacity beyond the current frames.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
  */
-typedef struct serfile {
-    void*       io_context;
-    size_t      (*reader)(void* io_context, void* buffer, size_t size, size_t offset);
-    size_t      (*writer)(void* io_context, const void* data, size_t size, size_t offset);
-    int         access_mode;
-
-	char		file_id[FILEID_LEN];
-	int32_t		lu_id;
-	int32_t		color_id;
-	int32_t		little_endian;
-	int32_t		image_width;
-	int32_t		image_height;
-	int32_t		pixel_depth_per_plane;
-	int32_t		frame_count;
-	char		observer[OBSERVER_LEN];
-	char		instrument[INSTRUMENT_LEN];
-	char		telescope[TELESCOPE_LEN];
-	int64_t		date_time;
-	int64_t		date_time_utc;
+int ser_shrink_to_fit(serfile* sptr, int* status);
 
-    bool        has_trailer;
-    int64_t*    timestamps;
-    size_t      timestamp_count;
-} serfile;
+/*  @brief  Number of frames the handle holds before its buffers grow.
+ *
+ *  Handles that buffer nothing in memory report the frame count.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  capacity    (IO)    - Capacity in frames.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_get_capacity(serfile* sptr, size_t* capacity, int* status);
 
-typedef struct {
-    uint8_t* data;
-    size_t size;
-    bool owns_buffer;
-} serMem;
 
+/*-------------------- Asynchronous Read Routines --------------------*/
 
-/*-------------------- Internal Routines --------------------*/
+/*  serasync keeps a number of frame reads in flight against one 
+ *  serfile. Reads are submitted with a destination buffer and are
+ *  collected later as completions. On Linux, positional handles and
+ *  read only file handles are served by an io_uring instance, which
+ *  keeps all depth reads in flight in the kernel. Other handles, or
+ *  systems where io_uring cannot be set up, are served by a pool of
+ *  worker threads, one per request up to a small limit for backends
+ *  that can be read concurrently and a single one otherwise.
+ *
+ *  A serasync must only be used from one thread at a time and the
+ *  serfile must not be written to while reads are in flight.
+ */
+typedef struct serasync serasync;
 
-#define RETURN_IF_STATUS_IS_ERROR(status)                       \
-    do {                                                        \
-        if ( *status ) { return (*status); }                    \
-    } while(0)                                                  \
+/*  A finished asynchronous read. status is NO_ERROR or the error
+ *  the equivalent ser_read_frame call would have reported.
+ */
+typedef struct sercompletion {
+    size_t  idx;
+    void*   dest;
+    void*   user_data;
+    int     status;
+} sercompletion;
+
+/*  @brief  Create an asynchronous read queue for a serfile.
+ *  @param  aptr        (IO)    - Pointer to a pointer of a serasync.
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  depth       (I)     - Maximum number of reads in flight.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_async_create(serasync** aptr, serfile* sptr, size_t depth, int* status);
 
-#define RETURN_IF_NULL_SPTRPTR(sptr, status)                    \
-    do {                                                        \
-        if ( !sptr ) { return (*status = NULL_SPTRPTR); }       \
-    } while(0)                                                  \
+/*  @brief  Submit a read of the frame at the index.
+ *
+ *  The dest buffer must hold a whole frame and stay valid until the
+ *  matching completion is collected. Fails with ASYNC_QUEUE_FULL if
+ *  depth reads are already in flight or waiting to be collected.
+ *
+ *  @param  aptr        (I)     - Pointer to serasync.
+ *  @param  dest        (IO)    - Pointer to destination buffer.
+ *  @param  idx         (I)     - Index of the frame.
+ *  @param  user_data   (I)     - Value returned with the completion.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_async_submit(serasync* aptr, void* dest, size_t idx, void* user_data, int* status);
 
-#define RETURN_IF_SPTR_OCCUPIED(sptr, status)                   \
-    do {                                                        \
-        if ( *sptr ) { return (*status = SPTR_OCCUPIED); }      \
-    } while(0)                                                  \
+/*  @brief  Collect finished reads without blocking.
+ *  @param  aptr        (I)     - Pointer to serasync.
+ *  @param  completions (IO)    - Destination array of completions.
+ *  @param  max         (I)     - Capacity of completions.
+ *  @param  count       (IO)    - Number of completions collected.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_async_poll(serasync* aptr, sercompletion* completions, size_t max, size_t* count, int* status);
 
-#define RETURN_IF_NULL_SPTR(sptr, status)                       \
-    do {                                                        \
-        if ( !sptr ) { return (*status = NULL_SPTR); }          \
-    } while(0)                                                  \
+/*  @brief  Collect finished reads, blocking until at least one is available.
+ *
+ *  Returns immediately with a count of 0 if nothing is in flight.
+ *
+ *  @param  aptr        (I)     - Pointer to serasync.
+ *  @param  completions (IO)    - Destination array of completions.
+ *  @param  max         (I)     - Capacity of completions.
+ *  @param  count       (IO)    - Number of completions collected.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_async_wait(serasync* aptr, sercompletion* completions, size_t max, size_t* count, int* status);
 
-#define RETURN_IF_NULL_DEST_BUFF(dest, status)                  \
-    do {                                                        \
-        if ( !dest ) { return (*status = NULL_DEST_BUFF); }     \
-    } while(0)                                                  \
+/*  @brief  Destroy an asynchronous read queue.
+ *
+ *  Waits for every read in flight to finish, discards uncollected
+ *  completions, and frees the structure. The serfile is not closed.
+ *
+ *  @param  aptr        (I)     - Pointer to serasync.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_async_destroy(serasync* aptr, int* status);
 
-#define RETURN_IF_NULL_PARAM(param, status)                     \
-    do {                                                        \
-        if ( !param ) { return (*status = NULL_PARAM); }        \
-    } while(0)                                                  \
+/*-------------------- Parallel Read Routines --------------------*/
 
-#define RETURN_IF_WRITE_ON_READONLY(sptr, status)               \
-    do {                                                        \
-        if ( sptr->access_mode == READONLY ) {                  \
-            return (*status = WRITE_ON_READONLY);               \
-        }                                                       \
+/*  @brief  Read a range of frames using several threads.
+ *
+ *  The range [first, first + count) is split into chunks that the
+ *  threads claim in turn, so faster threads take on more chunks.
+ *  Positional file handles read with pread on the shared descriptor,
+ *  mapped and memory handles copy from the mapping. Other handles
+ *  read the range on the calling thread. The call returns once every
+ *  frame is in dest.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  dest        (IO)    - Pointer to destination buffer.
+ *  @param  first       (I)     - Index of the first frame.
+ *  @param  count       (I)     - Number of frames to read.
+ *  @param  nthreads    (I)     - Number of threads, including the 
+ *                                caller. 0 uses one per online CPU.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_read_frames_parallel(serfile* sptr, void* dest, size_t first, size_t count, size_t nthreads, int* status);
+
+/*  @brief  Set the number of frames a thread reads at a time.
+ *
+ *  Applies to ser_read_frames_parallel. Larger chunks mean fewer,
+ *  larger reads, smaller chunks balance uneven devices better. 0 
+ *  restores the default of about 4 MB per chunk.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  frames      (I)     - Frames per chunk.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_set_parallel_chunk(serfile* sptr, size_t frames, int* status);
+
+/*-------------------- Frame Driver Routines --------------------*/
+
+/*  Called by ser_for_each_frame with the frame at index idx. The 
+ *  frame is only valid for the duration of the call. A non-zero 
+ *  return stops the iteration.
+ */
+typedef int (*serframefn)(size_t idx, const void* frame, void* user);
+
+/*  Options of ser_for_each_frame. A NULL pointer or a zeroed struct
+ *  gives one thread per online CPU and no completion callback.
+ *
+ *  complete runs after callback, on the same thread and with the 
+ *  same frame, but never concurrently with another complete. With
+ *  ordered set, complete is also called in ascending frame order.
+ */
+typedef struct serforeachopts {
+    size_t      nthreads;
+    bool        ordered;
+    serframefn  complete;
+} serforeachopts;
+
+/*  @brief  Run a callback on every frame of a range using several threads.
+ *
+ *  Each thread reads frames into a buffer of its own and calls 
+ *  callback on them. The range is split evenly between the threads
+ *  up front; a thread that runs out of frames takes half of what is
+ *  left to the busiest thread, so uneven callback costs even out.
+ *  Handles that cannot be read from several threads are walked on 
+ *  the calling thread.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  first       (I)     - Index of the first frame.
+ *  @param  count       (I)     - Number of frames.
+ *  @param  callback    (I)     - Called once per frame.
+ *  @param  user        (I)     - Passed through to the callbacks.
+ *  @param  opts        (I)     - Pointer to options, or NULL.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_for_each_frame(serfile* sptr, size_t first, size_t count, serframefn callback, void* user, const serforeachopts* opts, int* status);
+
+/*-------------------- Capture Queue Routines --------------------*/
+
+/*  sercapture decouples a frame source from the disk. Frames are 
+ *  copied into a preallocated ring of slots by one producer thread
+ *  and appended to the serfile by a dedicated writer thread. The 
+ *  producer side never takes a lock and never waits: when the ring
+ *  is full the frame is dropped and counted.
+ *
+ *  Exactly one thread may push frames. The serfile must not be used
+ *  in any other way until the sercapture is destroyed.
+ */
+typedef struct sercapture sercapture;
+
+/*  Counters of a sercapture. depth is the number of frames waiting
+ *  in the ring and high_water the largest depth seen so far. 
+ */
+typedef struct sercapturestats {
+    size_t  depth;
+    size_t  high_water;
+    size_t  written;
+    size_t  dropped;
+} sercapturestats;
+
+/*  @brief  Create a capture queue in front of ser_append_frame.
+ *
+ *  The ring of slots frames is allocated up front and the writer 
+ *  thread is started. The frame geometry of the serfile must be set
+ *  and must not change while the queue exists.
+ *
+ *  @param  cptr        (IO)    - Pointer to a pointer of a sercapture.
+ *  @param  sptr        (I)     - Pointer to serfile open for writing.
+ *  @param  slots       (I)     - Number of frames the ring holds.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_capture_create(sercapture** cptr, serfile* sptr, size_t slots, int* status);
+
+/*  @brief  Queue a frame for appending.
+ *
+ *  A whole frame is copied from data into a free slot. Fails with
+ *  ASYNC_QUEUE_FULL, and counts the frame as dropped, when every 
+ *  slot is waiting to be written.
+ *
+ *  @param  cptr        (I)     - Pointer to sercapture.
+ *  @param  data        (I)     - Pointer to data buffer.
+ *  @param  timestamp   (I)     - Timestamp.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_capture_push(sercapture* cptr, const void* data, uint64_t timestamp, int* status);
+
+/*  @brief  Read the counters of a capture queue.
+ *
+ *  May be called from any thread.
+ *
+ *  @param  cptr        (I)     - Pointer to sercapture.
+ *  @param  stats       (IO)    - Pointer to sercapturestats.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_capture_stats(sercapture* cptr, sercapturestats* stats, int* status);
+
+/*  @brief  Destroy a capture queue.
+ *
+ *  Waits for every queued frame to be appended, stops the writer, 
+ *  and frees the structure. The serfile is not closed. If an append
+ *  failed, its error is reported here; frames queued after the 
+ *  failure are counted as dropped.
+ *
+ *  @param  cptr        (I)     - Pointer to sercapture.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_capture_destroy(sercapture* cptr, int* status);
+
+
+/*-------------------- Asynchronous Append Routines --------------------*/
+
+/*  Called by the background writer once a frame queued with 
+ *  ser_append_frame_async has been appended, or has failed to be.
+ *  data is the pointer that was queued and may be reused from here,
+ *  though the frame may still be buffered by the backend writer.
+ */
+typedef void (*serappendfn)(const void* data, void* user, int status);
+
+/*  @brief  Queue a frame to be appended by a background writer.
+ *
+ *  The frame is not copied: data must stay valid and unchanged 
+ *  until done is called with it. Frames are appended in the order
+ *  they are queued, with the same header and trailer updates as 
+ *  ser_append_frame. Fails with ASYNC_QUEUE_FULL, without waiting,
+ *  when the queue is full. A frame leaves the queue before done is
+ *  called with it, so done may queue the next one.
+ *
+ *  If an append fails, the frames queued behind it and after it are
+ *  not written and complete with the same status. The next call to
+ *  ser_append_frame, ser_flush, ser_set_journal, ser_set_append_depth
+ *  or a close routine waits for the queue and returns that status,
+ *  which clears it.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  data        (I)     - Pointer to data buffer.
+ *  @param  timestamp   (I)     - Timestamp.
+ *  @param  done        (I)     - Completion callback, or NULL.
+ *  @param  user        (I)     - Passed through to done.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_append_frame_async(serfile* sptr, const void* data, uint64_t timestamp, serappendfn done, void* user, int* status);
+
+/*  @brief  Set how many frames ser_append_frame_async keeps queued.
+ *
+ *  Waits for the frames already queued, and returns the status of
+ *  an earlier failed append. 0 restores the default of 4 frames.
+ *
+ *  @param  sptr        (I)     - Pointer to serfile.
+ *  @param  depth       (I)     - Number of frames in flight.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_set_append_depth(serfile* sptr, size_t depth, int* status);
+
+/*-------------------- Rollover Routines --------------------*/
+
+/*  serrollover writes a long capture as a series of numbered SER 
+ *  files. For a path of night.ser the parts are night.0001.ser, 
+ *  night.0002.ser, ... and night.manifest lists them. Every part is
+ *  a complete SER with its own header and trailer.
+ */
+typedef struct serrollover serrollover;
+
+/*  @brief  Start a capture split into parts.
+ *
+ *  The first part is created immediately. Its header is taken from
+ *  the fields of header up to and including date_time_utc; the 
+ *  frame count is ignored. A part is finished before the frame that
+ *  would take it past max_bytes bytes, or past max_frames frames. 
+ *  Either limit may be 0 for none; a part always gets at least one
+ *  frame.
+ *
+ *  @param  rptr        (IO)    - Pointer to a pointer of a serrollover.
+ *  @param  path        (I)     - Path the part names derive from.
+ *  @param  header      (I)     - Header of every part.
+ *  @param  max_bytes   (I)     - Byte size limit of a part.
+ *  @param  max_frames  (I)     - Frame limit of a part.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_rollover_create(serrollover** rptr, const char* path, const serinfo* header, uint64_t max_bytes, size_t max_frames, int* status);
+
+/*  @brief  Append a frame, starting a new part when a limit is hit.
+ *
+ *  The header date and time of a new part are moved to the 
+ *  timestamp of its first frame, when the SER has a trailer.
+ *
+ *  @param  rptr        (I)     - Pointer to serrollover.
+ *  @param  data        (I)     - Pointer to data buffer.
+ *  @param  timestamp   (I)     - Timestamp.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_rollover_append(serrollover* rptr, const void* data, uint64_t timestamp, int* status);
+
+/*  @brief  Finish the current part and the manifest.
+ *
+ *  @param  rptr        (I)     - Pointer to serrollover.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_rollover_close(serrollover* rptr, int* status);
+
+
+/*-------------------- Memory-Backed SER Access Routines --------------------*/
+
+/*  @brief  Opens new in-memory SER file.
+ *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error status.
+ */
+int ser_create_memory(serfile** sptr, int* status);
+
+/*  @brief  Opens in-memory SER file.
+ *
+ *  For when a SER file is located in memory. Note that the 
+ *  data must persist so long as it is opened to the serfile.
+ *  Read and write routines only operate within the range
+ *  provided by size. 
+ *
+ *  @param  sptr      (IO)  - Pointer to a pointer of a serfile.
+ *  @param  data      (I)   - Pointer to data.
+ *  @param  size      (I)   - Size of data view.
+ *  @param  mode      (I)   - Access type (READONLY, READWRITE,
+ *                          or READSALVAGE).
+ *  @param  status    (IO)  - Error status.
+ *  @return Error status.
+ */
+int ser_open_view(serfile** sptr, uint8_t* data, size_t size, int mode, int* status);
+
+/*  @brief  Opens/Copies in-memory SER file.
+ *
+ *  Memory is allocated and managed by the serfile.
+ *
+ *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
+ *  @param  data        (I)     - Pointer to data.
+ *  @param  size        (I)     - Size to initially allocate / copy over.
+ *  @param  mode        (I)     - Access type (READONLY, READWRITE,
+ *                                or READSALVAGE).
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_open_memory(serfile** sptr, const uint8_t* data, size_t size, int mode, int* status);
+
+/*  @brief  Close in-memory SER file
+ *
+ *  Closes the serfile and frees the structure. Parameter sptr will
+ *  be set to NULL.
+ *
+ *  @param  sptr        (IO)    - Pointer to a serfile.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_close_memory(serfile* sptr, int* status);
+
+
+/*-------------------- Custom-Backed SER Access Routines --------------------*/
+
+/*  @brief  Create a new SER on a user supplied backend.
+ *
+ *  The header is initialized through the backend writer. The
+ *  serbackend is copied, so it need not outlive the call, but
+ *  its context must persist until the serfile is closed.
+ *
+ *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
+ *  @param  backend     (I)     - Backend callbacks.
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_create_custom(serfile** sptr, const serbackend* backend, int* status);
+
+/*  @brief  Opens an existing SER on a user supplied backend.
+ *
+ *  The structure is validated against the size reported by the
+ *  backend sizer. The writer may be NULL for READONLY handles.
+ *  Close with ser_close_file.
+ *
+ *  @param  sptr        (IO)    - Pointer to a pointer of a serfile.
+ *  @param  backend     (I)     - Backend callbacks.
+ *  @param  mode        (I)     - Access type (READONLY or READWRITE).
+ *  @param  status      (IO)    - Error status.
+ *  @return Error Status.
+ */
+int ser_open_custom(serfile** sptr, const serbackend* backend, int mode, int* status);
+
+
+/*------------------------------------------------------------------*/
+/* CSERIO Implementation */ 
+/*------------------------------------------------------------------*/
+
+#if defined(CSERIO_IMPLEMENTATION)
+
+#include <limits.h>
+#include <time.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CSERIO_POSIX
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#endif
+
+/* serasync reads through io_uring where the kernel headers have it,
+ * using the raw system calls. Define CSERIO_NO_IO_URING to keep the 
+ * thread pool only. */
+#if defined(CSERIO_POSIX) && defined(__linux__) && defined(__GNUC__) && defined(_GNU_SOURCE) \
+        && !defined(CSERIO_NO_IO_URING) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && defined(IORING_OFF_SQ_RING)
+#define CSERIO_IO_URING
+#endif
+#endif
+#endif
+
+
+/*-------------------- Structure Implementation --------------------*/
+
+/*  
+ *  serfile implementation.
+ */
+typedef struct serfile {
+    void*       io_context;
+    size_t      (*reader)(void* io_context, void* buffer, size_t size, uint64_t offset);
+    size_t      (*writer)(void* io_context, const void* data, size_t size, uint64_t offset);
+    uint64_t    (*sizer)(void* io_context);
+    int         (*flusher)(void* io_context);
+    int         (*closer)(void* io_context);
+    const void* (*lender)(void* io_context, size_t size, uint64_t offset);
+    int         (*reserver)(void* io_context, uint64_t size);
+    int         access_mode;
+    bool        reserved;
+    bool        follow;
+    bool        salvage;
+    uint64_t    follow_size;
+
+	char		file_id[FILEID_LEN];
+	int32_t		lu_id;
+	int32_t		color_id;
+	int32_t		little_endian;
+	int32_t		image_width;
+	int32_t		image_height;
+	int32_t		pixel_depth_per_plane;
+	int32_t		frame_count;
+	char		observer[OBSERVER_LEN];
+	char		instrument[INSTRUMENT_LEN];
+	char		telescope[TELESCOPE_LEN];
+	int64_t		date_time;
+	int64_t		date_time_utc;
+
+    bool        has_trailer;
+    bool        trailer_pending;
+    uint64_t    trailer_offset;
+    int64_t*    timestamps;
+    size_t      timestamp_count;
+    size_t      timestamp_capacity;
+    struct serShared*   shared;
+
+    int                 access_pattern;
+    struct serPrefetch* prefetch;
+    size_t              parallel_chunk;
+    struct serAppender* appender;
+    size_t              append_depth;
+
+    int         commit_policy;
+    size_t      commit_value;
+    size_t      uncommitted_frames;
+    uint64_t    committed_at;
+
+    struct serJournal*  journal;
+} serfile;
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    bool owns_buffer;
+} serMem;
+
+#if defined(CSERIO_POSIX)
+/* 
+ *  Mapping growth step. While a mapped file is open for writing,
+ *  the file is extended in steps of this size so appends do not
+ *  remap on every frame. It is truncated to its real size on close.
+ */
+#define SER_MAP_GROWTH_STEP                 ((size_t)64 << 20)
+
+typedef struct {
+    int fd;
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+    bool writable;
+} serMap;
+
+/* 
+ *  Direct IO staging. Writes to a direct handle are gathered in an
+ *  aligned staging buffer covering the tail of the file, and only
+ *  whole blocks are written through the direct descriptor. Reads and
+ *  header patches behind the stage use a second, buffered descriptor.
+ */
+#define SER_DIRECT_ALIGNMENT                ((size_t)4096)
+#define SER_DIRECT_STAGE_SIZE               ((size_t)8 << 20)
+
+typedef struct {
+    int fd;
+    int cached_fd;
+    uint8_t* stage;
+    uint64_t stage_offset;
+    size_t stage_length;
+    size_t stage_capacity;
+    uint64_t size;
+    uint64_t reserved;
+} serDirect;
+#endif
+
+
+/*-------------------- Internal Routines --------------------*/
+
+#define RETURN_IF_STATUS_IS_ERROR(status)                       \
+    do {                                                        \
+        if ( *status ) { return (*status); }                    \
+    } while(0)                                                  \
+
+#define RETURN_IF_NULL_SPTRPTR(sptr, status)                    \
+    do {                                                        \
+        if ( !sptr ) { return (*status = NULL_SPTRPTR); }       \
+    } while(0)                                                  \
+
+#define RETURN_IF_SPTR_OCCUPIED(sptr, status)                   \
+    do {                                                        \
+        if ( *sptr ) { return (*status = SPTR_OCCUPIED); }      \
+    } while(0)                                                  \
+
+#define RETURN_IF_NULL_SPTR(sptr, status)                       \
+    do {                                                        \
+        if ( !sptr ) { return (*status = NULL_SPTR); }          \
     } while(0)                                                  \
 
+#define RETURN_IF_NULL_DEST_BUFF(dest, status)                  \
+    do {                                                        \
+        if ( !dest ) { return (*status = NULL_DEST_BUFF); }     \
+    } while(0)                                                  \
+
+#define RETURN_IF_NULL_PARAM(param, status)                     \
+    do {                                                        \
+        if ( !param ) { return (*status = NULL_PARAM); }        \
+    } while(0)                                                  \
+
+#define RETURN_IF_WRITE_ON_READONLY(sptr, status)               \
+    do {                                                        \
+        if ( sptr->access_mode == READONLY ) {                  \
+            return (*status = WRITE_ON_READONLY);               \
+        }                                                       \
+    } while(0)                                                  \
+
+
+/*  Capacity to grow to when required no longer fits. Growing by
+ *  half of the current capacity keeps repeated appends amortized
+ *  O(1) without doubling large capture buffers.
+ */
+static size_t ser_grown_capacity(size_t capacity, size_t required) {
+    size_t grown = capacity + capacity / 2;
+    return grown > required ? grown : required;
+}
+
+static size_t ser_memory_read(void* io_context, void* buffer, size_t size, uint64_t offset) {
+    serMem* memory_io = (serMem*)(io_context);
+
+    if (memory_io->size < offset) {
+        return 0;
+    }
+
+    if (memory_io->size < offset + size) {
+        size_t cut_size = memory_io->size - offset;
+        memcpy(buffer, memory_io->data + offset, cut_size);
+        return cut_size;
+    }
+
+    memcpy(buffer, memory_io->data + offset, size);
+
+    return size;
+}
+
+static size_t ser_memory_write(void* io_context, const void* data, size_t size, uint64_t offset) {
+    serMem* memory_io = (serMem*)(io_context);
+
+    if (offset > SIZE_MAX - size) {
+        return 0;
+    }
+
+    if (!memory_io->owns_buffer) {
+        if (memory_io->size < offset) {
+            return 0;
+        }
+
+        if (memory_io->size < offset + size) {
+            size_t cut_size = memory_io->size - offset;
+            memcpy(memory_io->data + offset, data, cut_size);
+            return cut_size;
+        }
+    } else {
+        if (memory_io->capacity < offset + size) {
+            size_t new_capacity = ser_grown_capacity(memory_io->capacity, offset + size);
+            void* new_block = realloc(memory_io->data, new_capacity);
+            if (new_block) {
+                memory_io->data = (uint8_t*)new_block;
+                memory_io->capacity = new_capacity;
+            } else {
+                size_t cut_size = memory_io->size - offset;
+                memcpy(memory_io->data + offset, data, cut_size);
+                return cut_size;
+            }
+        }
+        if (memory_io->size < offset + size) {
+            memory_io->size = offset + size;
+        }
+    }
+
+    memcpy(memory_io->data + offset, data, size);
+
+    return size;
+}
+
+static const void* ser_memory_lend(void* io_context, size_t size, uint64_t offset) {
+    serMem* memory_io = (serMem*)(io_context);
+
+    if (memory_io->size < offset + size) {
+        return NULL;
+    }
+
+    return memory_io->data + offset;
+}
+
+static int ser_memory_reserve(void* io_context, uint64_t size) {
+    serMem* memory_io = (serMem*)(io_context);
+
+    if (!memory_io->owns_buffer || size > SIZE_MAX) {
+        return -1;
+    }
+
+    if (memory_io->capacity < size) {
+        void* new_block = realloc(memory_io->data, size);
+        if (!new_block) {
+            return -1;
+        }
+        memory_io->data = (uint8_t*)new_block;
+        memory_io->capacity = size;
+    }
+
+    return 0;
+}
+
+#if defined(CSERIO_POSIX)
+/*  Allocates disk blocks for the first size bytes of the file
+ *  without changing the file size. Blocks past the end of the
+ *  file are released again by truncating it to its size.
+ */
+static int ser_reserve_blocks(int fd, uint64_t size) {
+#if defined(FALLOC_FL_KEEP_SIZE)
+    while (fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, (off_t)size)) {
+        if (errno != EINTR) {
+            return -1;
+        }
+    }
+    return 0;
+#elif defined(F_PREALLOCATE)
+    struct stat file_stat;
+    if (fstat(fd, &file_stat)) {
+        return -1;
+    }
+    if (size <= (uint64_t)file_stat.st_size) {
+        return 0;
+    }
+
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t)(size - file_stat.st_size), 0 };
+    if (fcntl(fd, F_PREALLOCATE, &store) == -1) {
+        store.fst_flags = F_ALLOCATEALL;
+        if (fcntl(fd, F_PREALLOCATE, &store) == -1) {
+            return -1;
+        }
+    }
+    return 0;
+#else
+    (void)fd; (void)size;
+    return -1;
+#endif
+}
+#endif
+
+/*  64-bit fseek. long is 32 bits on Windows and 32-bit builds.
+ */
+static int ser_file_seek(FILE* file_io, uint64_t offset, int whence) {
+#if defined(CSERIO_POSIX)
+    if (offset > (uint64_t)INT64_MAX) {
+        return -1;
+    }
+    return fseeko(file_io, (off_t)offset, whence);
+#elif defined(_WIN32)
+    if (offset > (uint64_t)INT64_MAX) {
+        return -1;
+    }
+    return _fseeki64(file_io, (__int64)offset, whence);
+#else
+    if (offset > (uint64_t)LONG_MAX) {
+        return -1;
+    }
+    return fseek(file_io, (long)offset, whence);
+#endif
+}
+
+static size_t ser_file_read(void* io_context, void* buffer, size_t size, uint64_t offset) {
+    FILE* file_io = (FILE*)io_context;
+    if (ser_file_seek(file_io, offset, SEEK_SET)) {
+        return 0;
+    }
+    return fread(buffer, 1, size, file_io);
+}
+
+static size_t ser_file_write(void* io_context, const void* data, size_t size, uint64_t offset) {
+    FILE* file_io = (FILE*)io_context;
+    if (ser_file_seek(file_io, offset, SEEK_SET)) {
+        return 0;
+    }
+    return fwrite(data, 1, size, file_io);
+}
+
+static uint64_t ser_file_size(void* io_context) {
+    FILE* file_io = (FILE*)io_context;
+    if (ser_file_seek(file_io, 0, SEEK_END)) {
+        return 0;
+    }
+#if defined(CSERIO_POSIX)
+    off_t position = ftello(file_io);
+#elif defined(_WIN32)
+    __int64 position = _ftelli64(file_io);
+#else
+    long position = ftell(file_io);
+#endif
+    return position < 0 ? 0 : (uint64_t)position;
+}
+
+static int ser_file_flush(void* io_context) {
+    FILE* file_io = (FILE*)io_context;
+    if (fflush(file_io)) {
+        return EOF;
+    }
+#if defined(CSERIO_POSIX)
+    return fsync(fileno(file_io));
+#else
+    return 0;
+#endif
+}
+
+static int ser_file_close(void* io_context) {
+    return fclose((FILE*)io_context);
+}
+
+static int ser_file_reserve(void* io_context, uint64_t size) {
+#if defined(CSERIO_POSIX)
+    FILE* file_io = (FILE*)io_context;
+    return ser_reserve_blocks(fileno(file_io), size);
+#else
+    (void)io_context; (void)size;
+    return -1;
+#endif
+}
+
+static uint64_t ser_memory_size(void* io_context) {
+    return ((serMem*)io_context)->size;
+}
+
+static int ser_memory_close(void* io_context) {
+    serMem* memory_io = (serMem*)(io_context);
+    if (memory_io->owns_buffer) {
+        free(memory_io->data);
+    }
+    free(memory_io);
+    return 0;
+}
+
+#if defined(CSERIO_POSIX)
+static size_t ser_map_read(void* io_context, void* buffer, size_t size, uint64_t offset) {
+    serMap* map_io = (serMap*)(io_context);
+
+    if (map_io->size < offset) {
+        return 0;
+    }
+
+    if (map_io->size < offset + size) {
+        size = map_io->size - offset;
+    }
+
+    memcpy(buffer, map_io->data + offset, size);
+
+    return size;
+}
+
+static const void* ser_map_lend(void* io_context, size_t size, uint64_t offset) {
+    serMap* map_io = (serMap*)(io_context);
+
+    if (map_io->size < offset + size) {
+        return NULL;
+    }
+
+    return map_io->data + offset;
+}
+
+static bool ser_map_grow(serMap* map_io, size_t required) {
+    if (required > SIZE_MAX - SER_MAP_GROWTH_STEP) {
+        return false;
+    }
+
+    size_t new_capacity = required + SER_MAP_GROWTH_STEP - 1;
+    new_capacity -= new_capacity % SER_MAP_GROWTH_STEP;
+
+    /* blocks are allocated now, as stores into a hole on a full disk raise SIGBUS */
+    if (posix_fallocate(map_io->fd, (off_t)map_io->capacity, (off_t)(new_capacity - map_io->capacity))) {
+        ftruncate(map_io->fd, map_io->capacity);
+        return false;
+    }
+
+    void* new_block = mmap(
+            NULL,
+            new_capacity,
+            PROT_READ | PROT_WRITE,
+            MAP_SHARED,
+            map_io->fd,
+            0
+    );
+    if (new_block == MAP_FAILED) {
+        ftruncate(map_io->fd, map_io->capacity);
+        return false;
+    }
+
+    munmap(map_io->data, map_io->capacity);
+    map_io->data = (uint8_t*)new_block;
+    map_io->capacity = new_capacity;
+    return true;
+}
+
+static size_t ser_map_write(void* io_context, const void* data, size_t size, uint64_t offset) {
+    serMap* map_io = (serMap*)(io_context);
+
+    if (!map_io->writable || offset > SIZE_MAX - size) {
+        return 0;
+    }
+
+    if (map_io->capacity < offset + size && !ser_map_grow(map_io, offset + size)) {
+        if (map_io->capacity < offset) {
+            return 0;
+        }
+        size = map_io->capacity - offset;
+    }
+
+    memcpy(map_io->data + offset, data, size);
+    if (map_io->size < offset + size) {
+        map_io->size = offset + size;
+    }
+
+    return size;
+}
+
+static size_t ser_fd_read(void* io_context, void* buffer, size_t size, uint64_t offset) {
+    int fd = *(int*)io_context;
+    size_t total = 0;
+
+    while (total < size) {
+        ssize_t count = pread(fd, (uint8_t*)buffer + total, size - total, (off_t)(offset + total));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        total += count;
+    }
+
+    return total;
+}
+
+static size_t ser_fd_write(void* io_context, const void* data, size_t size, uint64_t offset) {
+    int fd = *(int*)io_context;
+    size_t total = 0;
+
+    while (total < size) {
+        ssize_t count = pwrite(fd, (const uint8_t*)data + total, size - total, (off_t)(offset + total));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            break;
+        }
+        total += count;
+    }
+
+    return total;
+}
+
+static uint64_t ser_fd_size(void* io_context) {
+    struct stat file_stat;
+    if (fstat(*(int*)io_context, &file_stat)) {
+        return 0;
+    }
+    return file_stat.st_size;
+}
+
+static int ser_fd_flush(void* io_context) {
+    return fsync(*(int*)io_context);
+}
+
+static int ser_fd_reserve(void* io_context, uint64_t size) {
+    return ser_reserve_blocks(*(int*)io_context, size);
+}
+
+static int ser_fd_close(void* io_context) {
+    int result = close(*(int*)io_context);
+    free(io_context);
+    return result;
+}
+
+static uint64_t ser_map_size(void* io_context) {
+    return ((serMap*)io_context)->size;
+}
+
+static int ser_map_flush(void* io_context) {
+    serMap* map_io = (serMap*)(io_context);
+    return msync(map_io->data, map_io->capacity, MS_SYNC);
+}
+
+static int ser_map_reserve(void* io_context, uint64_t size) {
+    serMap* map_io = (serMap*)(io_context);
+
+    if (!map_io->writable || size > SIZE_MAX) {
+        return -1;
+    }
+
+    if (map_io->capacity < size && !ser_map_grow(map_io, size)) {
+        return -1;
+    }
+
+    /* growing only extends the file sparsely */
+    return ser_reserve_blocks(map_io->fd, size);
+}
+
+static int ser_map_close(void* io_context) {
+    serMap* map_io = (serMap*)(io_context);
+    int result = munmap(map_io->data, map_io->capacity);
+
+    /* drop any growth step that was never written to */
+    if (map_io->writable && map_io->capacity != map_io->size) {
+        result |= ftruncate(map_io->fd, map_io->size);
+    }
+
+    result |= close(map_io->fd);
+    free(map_io);
+    return result;
+}
+
+static size_t ser_direct_align_up(size_t value) {
+    return (value + SER_DIRECT_ALIGNMENT - 1) & ~(SER_DIRECT_ALIGNMENT - 1);
+}
+
+/*  Writes the whole blocks of the stage and moves the partial
+ *  block at its end to the front.
+ */
+static bool ser_direct_spill(serDirect* direct_io) {
+    size_t whole = direct_io->stage_length & ~(SER_DIRECT_ALIGNMENT - 1);
+    if (whole == 0) {
+        return true;
+    }
+
+    if (ser_fd_write(&direct_io->fd, direct_io->stage, whole, direct_io->stage_offset) != whole) {
+        return false;
+    }
+
+    direct_io->stage_length -= whole;
+    memmove(direct_io->stage, direct_io->stage + whole, direct_io->stage_length);
+    direct_io->stage_offset += whole;
+    return true;
+}
+
+/*  Writes the whole stage, padding its last block, and cuts the
+ *  padding off again. The stage keeps its contents.
+ */
+static bool ser_direct_drain(serDirect* direct_io) {
+    if (direct_io->stage_length == 0) {
+        return true;
+    }
+
+    size_t padded = ser_direct_align_up(direct_io->stage_length);
+    memset(direct_io->stage + direct_io->stage_length, 0, padded - direct_io->stage_length);
+    if (ser_fd_write(&direct_io->fd, direct_io->stage, padded, direct_io->stage_offset) != padded) {
+        return false;
+    }
+
+    if (ftruncate(direct_io->fd, (off_t)direct_io->size)) {
+        return false;
+    }
+
+    /* cutting the padding also released any reservation */
+    if (direct_io->reserved > direct_io->size) {
+        ser_reserve_blocks(direct_io->cached_fd, direct_io->reserved);
+    }
+    return true;
+}
+
+/*  Drains the stage and moves it to the block holding offset,
+ *  loading whatever the file already has there.
+ */
+static bool ser_direct_reposition(serDirect* direct_io, uint64_t offset) {
+    if (!ser_direct_drain(direct_io)) {
+        return false;
+    }
+
+    direct_io->stage_offset = offset & ~(uint64_t)(SER_DIRECT_ALIGNMENT - 1);
+    direct_io->stage_length = 0;
+    if (direct_io->size > direct_io->stage_offset) {
+        uint64_t length = direct_io->size - direct_io->stage_offset;
+        if (length > direct_io->stage_capacity) {
+            length = direct_io->stage_capacity;
+        }
+        direct_io->stage_length = ser_fd_read(
+                &direct_io->cached_fd, 
+                direct_io->stage, 
+                (size_t)length, 
+                direct_io->stage_offset
+        );
+        if (direct_io->stage_length != length) {
+            direct_io->stage_length = 0;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool ser_direct_grow(serDirect* direct_io, size_t required) {
+    size_t new_capacity = ser_direct_align_up(required);
+    void* new_stage = NULL;
+    if (posix_memalign(&new_stage, SER_DIRECT_ALIGNMENT, new_capacity)) {
+        return false;
+    }
+
+    memcpy(new_stage, direct_io->stage, direct_io->stage_length);
+    free(direct_io->stage);
+    direct_io->stage = (uint8_t*)new_stage;
+    direct_io->stage_capacity = new_capacity;
+    return true;
+}
+
+static size_t ser_direct_read(void* io_context, void* buffer, size_t size, uint64_t offset) {
+    serDirect* direct_io = (serDirect*)(io_context);
+    uint8_t* dest = (uint8_t*)buffer;
+    size_t total = 0;
+
+    if (offset < direct_io->stage_offset) {
+        size_t behind = size;
+        if (direct_io->stage_offset - offset < size) {
+            behind = (size_t)(direct_io->stage_offset - offset);
+        }
+        total = ser_fd_read(&direct_io->cached_fd, dest, behind, offset);
+        if (total < behind) {
+            return total;
+        }
+    }
+
+    uint64_t stage_end = direct_io->stage_offset + direct_io->stage_length;
+    if (total < size && offset + total < stage_end) {
+        size_t position = (size_t)(offset + total - direct_io->stage_offset);
+        size_t count = direct_io->stage_length - position;
+        if (count > size - total) {
+            count = size - total;
+        }
+        memcpy(dest + total, direct_io->stage + position, count);
+        total += count;
+    }
+
+    /* the stage may end before the file does, the rest is on disk */
+    if (total < size && offset + total >= stage_end) {
+        total += ser_fd_read(&direct_io->cached_fd, dest + total, size - total, offset + total);
+    }
+
+    return total;
+}
+
+static size_t ser_direct_write(void* io_context, const void* data, size_t size, uint64_t offset) {
+    serDirect* direct_io = (serDirect*)(io_context);
+    const uint8_t* source = (const uint8_t*)data;
+    size_t total = 0;
+
+    /* header patches behind the stage go through the buffered descriptor */
+    if (offset < direct_io->stage_offset) {
+        size_t behind = size;
+        if (direct_io->stage_offset - offset < size) {
+            behind = (size_t)(direct_io->stage_offset - offset);
+        }
+        total = ser_fd_write(&direct_io->cached_fd, source, behind, offset);
+        if (total < behind) {
+            return total;
+        }
+    }
+
+    if (total < size && offset + total > direct_io->stage_offset + direct_io->stage_length) {
+        if (!ser_direct_reposition(direct_io, offset + total)) {
+            return total;
+        }
+    }
+
+    while (total < size) {
+        size_t position = (size_t)(offset + total - direct_io->stage_offset);
+        if (position == direct_io->stage_capacity) {
+            if (!ser_direct_spill(direct_io)) {
+                break;
+            }
+            continue;
+        }
+
+        if (position > direct_io->stage_length) {
+            memset(direct_io->stage + direct_io->stage_length, 0, position - direct_io->stage_length);
+        }
+
+        size_t count = direct_io->stage_capacity - position;
+        if (count > size - total) {
+            count = size - total;
+        }
+
+        /* frames filled in place through ser_get_append_buffer need no copy */
+        uint8_t* target = direct_io->stage + position;
+        if (target != source + total) {
+            memmove(target, source + total, count);
+        }
+
+        total += count;
+        if (direct_io->stage_length < position + count) {
+            direct_io->stage_length = position + count;
+        }
+    }
+
+    if (direct_io->size < offset + total) {
+        direct_io->size = offset + total;
+    }
+
+    return total;
+}
+
+/*  Returns the stage memory for size bytes at offset, making room
+ *  for them first. 
+ */
+static int ser_direct_slot(serDirect* direct_io, uint64_t offset, size_t size, uint8_t** slot) {
+    uint64_t stage_end = direct_io->stage_offset + direct_io->stage_length;
+    if (offset < direct_io->stage_offset || offset > stage_end) {
+        if (!ser_direct_reposition(direct_io, offset)) {
+            return IMAGE_WRITE_WARN;
+        }
+    }
+
+    if (offset + size - direct_io->stage_offset > direct_io->stage_capacity) {
+        bool moved = offset == direct_io->stage_offset + direct_io->stage_length
+            ? ser_direct_spill(direct_io)
+            : ser_direct_reposition(direct_io, offset);
+        if (!moved) {
+            return IMAGE_WRITE_WARN;
+        }
+    }
+
+    uint64_t required = offset + size - direct_io->stage_offset;
+    if (required > SIZE_MAX - SER_DIRECT_ALIGNMENT) {
+        return SIZE_OVERFLOW;
+    }
+    if (required > direct_io->stage_capacity && !ser_direct_grow(direct_io, (size_t)required)) {
+        return MEM_ALLOC;
+    }
+
+    *slot = direct_io->stage + (size_t)(offset - direct_io->stage_offset);
+    return NO_ERROR;
+}
+
+static uint64_t ser_direct_size(void* io_context) {
+    return ((serDirect*)io_context)->size;
+}
+
+static int ser_direct_flush(void* io_context) {
+    serDirect* direct_io = (serDirect*)(io_context);
+    if (!ser_direct_drain(direct_io)) {
+        return -1;
+    }
+
+    int result = fsync(direct_io->fd);
+    if (direct_io->cached_fd != direct_io->fd) {
+        result |= fsync(direct_io->cached_fd);
+    }
+    return result;
+}
+
+static int ser_direct_reserve(void* io_context, uint64_t size) {
+    serDirect* direct_io = (serDirect*)(io_context);
+    if (ser_reserve_blocks(direct_io->cached_fd, size)) {
+        return -1;
+    }
+
+    if (direct_io->reserved < size) {
+        direct_io->reserved = size;
+    }
+    return 0;
+}
+
+static int ser_direct_close(void* io_context) {
+    serDirect* direct_io = (serDirect*)(io_context);
+    direct_io->reserved = 0;
+    int result = ser_direct_drain(direct_io) ? 0 : -1;
+
+    if (direct_io->cached_fd != direct_io->fd) {
+        result |= close(direct_io->cached_fd);
+    }
+    result |= close(direct_io->fd);
+    free(direct_io->stage);
+    free(direct_io);
+    return result;
+}
+
+/*  Opens the direct descriptor next to the buffered one. Without
+ *  direct IO support the buffered descriptor is used for both.
+ */
+static serDirect* ser_direct_attach(const char* path, int cached_fd) {
+    serDirect* direct_io = (serDirect*)calloc(1, sizeof(serDirect));
+    if (!direct_io) {
+        return NULL;
+    }
+
+    if (posix_memalign((void**)&direct_io->stage, SER_DIRECT_ALIGNMENT, SER_DIRECT_STAGE_SIZE)) {
+        free(direct_io);
+        return NULL;
+    }
+    direct_io->stage_capacity = SER_DIRECT_STAGE_SIZE;
+    direct_io->cached_fd = cached_fd;
+    direct_io->fd = -1;
+
+#if defined(O_DIRECT)
+    direct_io->fd = open(path, O_RDWR | O_DIRECT);
+#else
+    (void)path;
+#endif
+    if (direct_io->fd < 0) {
+        direct_io->fd = cached_fd;
+#if defined(F_NOCACHE)
+        fcntl(cached_fd, F_NOCACHE, 1);
+#endif
+    }
+
+    return direct_io;
+}
+#endif
+
+/*  Packs the header fields of sptr into their on-disk layout so 
+ *  the header is written with a single backend call.
+ */
+static void ser_header_encode(const serfile* sptr, uint8_t* header) {
+    memcpy(header + FILEID_KEY,             sptr->file_id,                  FILEID_LEN);
+    memcpy(header + LUID_KEY,               &sptr->lu_id,                   LUID_LEN);
+    memcpy(header + COLORID_KEY,            &sptr->color_id,                COLORID_LEN);
+    memcpy(header + LITTLEENDIAN_KEY,       &sptr->little_endian,           LITTLEENDIAN_LEN);
+    memcpy(header + IMAGEWIDTH_KEY,         &sptr->image_width,             IMAGEWIDTH_LEN);
+    memcpy(header + IMAGEHEIGHT_KEY,        &sptr->image_height,            IMAGEHEIGHT_LEN);
+    memcpy(header + PIXELDEPTHPERPLANE_KEY, &sptr->pixel_depth_per_plane,   PIXELDEPTHPERPLANE_LEN);
+    memcpy(header + FRAMECOUNT_KEY,         &sptr->frame_count,             FRAMECOUNT_LEN);
+    memcpy(header + OBSERVER_KEY,           sptr->observer,                 OBSERVER_LEN);
+    memcpy(header + INSTRUMENT_KEY,         sptr->instrument,               INSTRUMENT_LEN);
+    memcpy(header + TELESCOPE_KEY,          sptr->telescope,                TELESCOPE_LEN);
+    memcpy(header + DATETIME_KEY,           &sptr->date_time,               DATETIME_LEN);
+    memcpy(header + DATETIMEUTC_KEY,        &sptr->date_time_utc,           DATETIMEUTC_LEN);
+}
+
+/*  Unpacks a header read with a single backend call into sptr.
+ */
+static void ser_header_decode(serfile* sptr, const uint8_t* header) {
+    memcpy(sptr->file_id,                   header + FILEID_KEY,             FILEID_LEN);
+    memcpy(&sptr->lu_id,                    header + LUID_KEY,               LUID_LEN);
+    memcpy(&sptr->color_id,                 header + COLORID_KEY,            COLORID_LEN);
+    memcpy(&sptr->little_endian,            header + LITTLEENDIAN_KEY,       LITTLEENDIAN_LEN);
+    memcpy(&sptr->image_width,              header + IMAGEWIDTH_KEY,         IMAGEWIDTH_LEN);
+    memcpy(&sptr->image_height,             header + IMAGEHEIGHT_KEY,        IMAGEHEIGHT_LEN);
+    memcpy(&sptr->pixel_depth_per_plane,    header + PIXELDEPTHPERPLANE_KEY, PIXELDEPTHPERPLANE_LEN);
+    memcpy(&sptr->frame_count,              header + FRAMECOUNT_KEY,         FRAMECOUNT_LEN);
+    memcpy(sptr->observer,                  header + OBSERVER_KEY,           OBSERVER_LEN);
+    memcpy(sptr->instrument,                header + INSTRUMENT_KEY,         INSTRUMENT_LEN);
+    memcpy(sptr->telescope,                 header + TELESCOPE_KEY,          TELESCOPE_LEN);
+    memcpy(&sptr->date_time,                header + DATETIME_KEY,           DATETIME_LEN);
+    memcpy(&sptr->date_time_utc,            header + DATETIMEUTC_KEY,        DATETIMEUTC_LEN);
+}
+
+static void ser_header_initializations(serfile* sptr) {
+    memset(sptr->file_id,           0, FILEID_LEN);
+    sptr->lu_id =                   0;
+    sptr->color_id =                MONO;
+    sptr->little_endian =           LITTLEENDIAN_TRUE;
+    sptr->image_width =             0;
+    sptr->image_height =            0;
+    sptr->pixel_depth_per_plane =   8;
+    sptr->frame_count =             0;
+    memset(sptr->observer,          0, OBSERVER_LEN);
+    memset(sptr->instrument,        0, INSTRUMENT_LEN);
+    memset(sptr->telescope,         0, TELESCOPE_LEN);
+    sptr->date_time =               0;
+    sptr->date_time_utc =           0;
+
+    uint8_t header[HDR_SIZE];
+    ser_header_encode(sptr, header);
+    sptr->writer(sptr->io_context, header, HDR_SIZE, 0);
+}
+
+/*  Computes base + count * unit as a file offset. Returns false 
+ *  when the result does not fit in 64 bits.
+ */
+static bool ser_offset_of(uint64_t base, uint64_t count, uint64_t unit, uint64_t* offset) {
+    if (unit && count > (UINT64_MAX - base) / unit) {
+        return false;
+    }
+
+    *offset = base + count * unit;
+    return true;
+}
+
+/*  Verifies that a decoded header agrees with a SER of size bytes
+ *  and locates the trailer. Returns false for an invalid structure.
+ */
+static bool ser_structure_valid(serfile* sptr, uint64_t size, uint64_t* trailer_offset) {
+    int status = 0;
+    unsigned long frame_byte_size = 0;
+    if (ser_get_frame_byte_size(sptr, &frame_byte_size, &status) 
+            || sptr->frame_count < 0
+            || !ser_offset_of(HDR_SIZE, sptr->frame_count, frame_byte_size, trailer_offset)) {
+        return false;
+    }
+
+    if (size < *trailer_offset) {
+        return false;
+    }
+
+    if (sptr->date_time > 0) {
+        return size - *trailer_offset == (uint64_t)sptr->frame_count * sizeof(int64_t);
+    }
+    return size == *trailer_offset;
+}
+
+/*  Follow mode counterpart of ser_structure_valid. The frames are 
+ *  those counted by the header whose data is entirely on disk; what
+ *  follows them is either a complete trailer or an append still in 
+ *  progress. Nothing marks a trailer as finished and a partial 
+ *  frame can have its size, so a trailer is only located once the
+ *  file was seen at the same size on the previous call as well. 
+ *  Timestamps held by sptr must have been released. Returns an 
+ *  error code.
+ */
+static int ser_follow_locate(serfile* sptr, uint64_t size) {
+    if (size < HDR_SIZE) {
+        return INVALID_STRUCTURE;
+    }
+
+    int status = 0;
+    unsigned long frame_byte_size = 0;
+    if (ser_get_frame_byte_size(sptr, &frame_byte_size, &status) || sptr->frame_count < 0) {
+        return INVALID_STRUCTURE;
+    }
+
+    uint64_t data_end = 0;
+    if (frame_byte_size && (uint64_t)sptr->frame_count > (size - HDR_SIZE) / frame_byte_size) {
+        sptr->frame_count = (int32_t)((size - HDR_SIZE) / frame_byte_size);
+    }
+    if (!ser_offset_of(HDR_SIZE, sptr->frame_count, frame_byte_size, &data_end)) {
+        return INVALID_STRUCTURE;
+    }
+
+    sptr->timestamps = NULL;
+    sptr->trailer_pending = false;
+    sptr->timestamp_count = 0;
+    sptr->timestamp_capacity = 0;
+    bool has_trailer = sptr->has_trailer && sptr->frame_count > 0
+            && size - data_end == (uint64_t)sptr->frame_count * sizeof(int64_t);
+
+    /* the size grows with every frame, so an unchanged one means the same frame count */
+    if (has_trailer && size == sptr->follow_size) {
+        sptr->trailer_pending = true;
+        sptr->trailer_offset = data_end;
+        sptr->timestamp_count = sptr->frame_count;
+    }
+    sptr->follow_size = has_trailer ? size : 0;
+
+    return NO_ERROR;
+}
+
+/*  Whether count timestamps at offset can be a trailer: none of 
+ *  them predates the header dates and they never decrease.
+ */
+static bool ser_trailer_plausible(serfile* sptr, uint64_t offset, uint64_t count) {
+    int64_t previous = sptr->date_time;
+    if (sptr->date_time_utc > 0 && sptr->date_time_utc < previous) {
+        previous = sptr->date_time_utc;
+    }
+
+    int64_t chunk[512];
+    while (count) {
+        size_t chunk_count = count < 512 ? (size_t)count : 512;
+        size_t chunk_size = chunk_count * sizeof(int64_t);
+        if (sptr->reader(sptr->io_context, chunk, chunk_size, offset) != chunk_size) {
+            return false;
+        }
+        for (size_t i = 0; i < chunk_count; i++) {
+            if (chunk[i] < previous) {
+                return false;
+            }
+            previous = chunk[i];
+        }
+        count -= chunk_count;
+        offset += chunk_size;
+    }
+    return true;
+}
+
+/*  Salvage mode counterpart of ser_structure_valid. The header frame
+ *  count is kept when its frames are on disk and what follows them 
+ *  is no more than a trailer or a partial frame. A tail that holds 
+ *  whole frames must also read as plausible timestamps, or frames 
+ *  were appended past a stale header. The frame count is then 
+ *  inferred from the size, ignoring a partial last frame. Only the
+ *  complete timestamps of a trailer that follows trusted frames 
+ *  are located. Returns an error code.
+ */
+static int ser_salvage_locate(serfile* sptr, uint64_t size) {
+    int status = 0;
+    unsigned long frame_byte_size = 0;
+    if (size < HDR_SIZE
+            || ser_get_frame_byte_size(sptr, &frame_byte_size, &status) 
+            || frame_byte_size == 0) {
+        return INVALID_STRUCTURE;
+    }
+
+    bool has_trailer = sptr->date_time > 0;
+    uint64_t frames_on_disk = (size - HDR_SIZE) / frame_byte_size;
+    uint64_t data_end = 0;
+    bool trusted = sptr->frame_count >= 0
+            && (uint64_t)sptr->frame_count <= frames_on_disk
+            && ser_offset_of(HDR_SIZE, sptr->frame_count, frame_byte_size, &data_end);
+
+    /* small frames appended past the header fit where a trailer would be */
+    if (trusted && (uint64_t)sptr->frame_count != frames_on_disk) {
+        uint64_t tail = size - data_end;
+        trusted = has_trailer 
+            && tail >= sizeof(int64_t)
+            && tail <= (uint64_t)sptr->frame_count * sizeof(int64_t)
+            && ser_trailer_plausible(sptr, data_end, tail / sizeof(int64_t));
+    }
+
+    if (!trusted) {
+        sptr->frame_count = frames_on_disk > INT32_MAX ? INT32_MAX : (int32_t)frames_on_disk;
+        if (!ser_offset_of(HDR_SIZE, sptr->frame_count, frame_byte_size, &data_end)) {
+            return INVALID_STRUCTURE;
+        }
+    }
+
+    sptr->timestamp_count = 0;
+    if (has_trailer && trusted) {
+        sptr->timestamp_count = (size - data_end) / sizeof(int64_t);
+        if (sptr->timestamp_count > (uint64_t)sptr->frame_count) {
+            sptr->timestamp_count = sptr->frame_count;
+        }
+        sptr->trailer_offset = data_end;
+    }
+    sptr->trailer_pending = sptr->timestamp_count > 0;
+    return NO_ERROR;
+}
+
+/*  Reads the header of an opened SER and verifies that the header
+ *  agrees with the size of the data. A present trailer is only 
+ *  located here, it is loaded on first use by ser_load_trailer.
+ *  On INVALID_STRUCTURE the caller is responsible for the cleanup.
+ */
+static int ser_open_initializations(serfile* sptr, uint64_t size, int* status) {
+    uint8_t header[HDR_SIZE];
+    if (sptr->reader(sptr->io_context, header, HDR_SIZE, 0) != HDR_SIZE) {
+        return (*status = INVALID_STRUCTURE);
+    }
+    ser_header_decode(sptr, header);
+    sptr->has_trailer = sptr->date_time <= 0 ? false : true;
+    sptr->timestamps = NULL;
+    sptr->trailer_pending = false;
+    sptr->timestamp_count = 0;
+    sptr->timestamp_capacity = 0;
+
+    if (sptr->follow) {
+        return (*status = ser_follow_locate(sptr, size));
+    }
+    if (sptr->salvage) {
+        return (*status = ser_salvage_locate(sptr, size));
+    }
+
+    /* determine if valid hdr + data or hdr + data + trailer */
+    uint64_t trailer_offset = 0;
+    if (!ser_structure_valid(sptr, size, &trailer_offset)) {
+        return (*status = INVALID_STRUCTURE);
+    }
+
+    if (sptr->has_trailer) {
+        sptr->trailer_pending = sptr->frame_count > 0;
+        sptr->trailer_offset = trailer_offset;
+        sptr->timestamp_count = sptr->frame_count;
+    }
+
+    return (*status);
+}
+
+/*  Computes the byte offset and byte size of the frame range
+ *  [first, first + count) once the range is known to be in bounds.
+ */
+static int ser_frame_span(serfile* sptr, size_t first, size_t count, uint64_t* offset, size_t* size, int* status) {
+    size_t frame_count = sptr->frame_count;
+    if (first >= frame_count || count > frame_count - first) {
+        return (*status = INVALID_FRAME_IDX); 
+    }
+
+    unsigned long frame_byte_size = 0;
+    ser_get_frame_byte_size(sptr, &frame_byte_size, status);
+    if (*status) { 
+        return (*status); 
+    }
+
+    if (frame_byte_size && count > SIZE_MAX / frame_byte_size) {
+        return (*status = SIZE_OVERFLOW);
+    }
+
+    if (!ser_offset_of(HDR_SIZE, first, frame_byte_size, offset)) {
+        return (*status = SIZE_OVERFLOW);
+    }
+    *size = frame_byte_size * count;
+    return (*status);
+}
+
+#if defined(CSERIO_POSIX)
+/*  Returns the file descriptor behind a built-in file backend,
+ *  or -1 for memory and custom backends.
+ */
+static int ser_backend_fd(serfile* sptr) {
+    if (sptr->reader == ser_fd_read) {
+        return *(int*)sptr->io_context;
+    }
+    if (sptr->reader == ser_map_read) {
+        return ((serMap*)sptr->io_context)->fd;
+    }
+    if (sptr->reader == ser_file_read) {
+        return fileno((FILE*)sptr->io_context);
+    }
+    if (sptr->reader == ser_direct_read) {
+        return ((serDirect*)sptr->io_context)->cached_fd;
+    }
+    return -1;
+}
+
+/* 
+ *  Background prefetcher, see ser_set_prefetch.
+ */
+typedef struct serPrefetch {
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    int             fd;
+    size_t          frame_byte_size;
+    size_t          distance;
+    size_t          next;
+    size_t          target;
+    bool            stopping;
+} serPrefetch;
+
+static void* ser_prefetch_worker(void* arg) {
+    serPrefetch* prefetch = (serPrefetch*)arg;
+
+    pthread_mutex_lock(&prefetch->lock);
+    while (!prefetch->stopping) {
+        if (prefetch->next >= prefetch->target) {
+            pthread_cond_wait(&prefetch->wake, &prefetch->lock);
+            continue;
+        }
+
+        /* the kernel reads the window in, nothing is copied here */
+        size_t first = prefetch->next;
+        size_t count = prefetch->target - first;
+        prefetch->next = prefetch->target;
+        pthread_mutex_unlock(&prefetch->lock);
+
+#if defined(POSIX_FADV_WILLNEED)
+        uint64_t offset = HDR_SIZE + (uint64_t)prefetch->frame_byte_size * first;
+        uint64_t size = (uint64_t)prefetch->frame_byte_size * count;
+        posix_fadvise(prefetch->fd, (off_t)offset, (off_t)size, POSIX_FADV_WILLNEED);
+#else
+        (void)first; (void)count;
+#endif
+
+        pthread_mutex_lock(&prefetch->lock);
+    }
+    pthread_mutex_unlock(&prefetch->lock);
+
+    return NULL;
+}
+
+/*  Moves the prefetch window to start at frame idx. A read outside
+ *  of the current window restarts prefetching from idx.
+ */
+static void ser_prefetch_advance(serfile* sptr, size_t idx) {
+    serPrefetch* prefetch = sptr->prefetch;
+    size_t frame_count = sptr->frame_count;
+
+    pthread_mutex_lock(&prefetch->lock);
+    if (idx > prefetch->next || idx + prefetch->distance < prefetch->next) {
+        prefetch->next = idx;
+    }
+    prefetch->target = idx + prefetch->distance;
+    if (prefetch->target > frame_count) {
+        prefetch->target = frame_count;
+    }
+    pthread_cond_signal(&prefetch->wake);
+    pthread_mutex_unlock(&prefetch->lock);
+}
+
+static void ser_prefetch_stop(serfile* sptr) {
+    serPrefetch* prefetch = sptr->prefetch;
+    if (!prefetch) {
+        return;
+    }
+
+    pthread_mutex_lock(&prefetch->lock);
+    prefetch->stopping = true;
+    pthread_cond_signal(&prefetch->wake);
+    pthread_mutex_unlock(&prefetch->lock);
+    pthread_join(prefetch->thread, NULL);
+
+    pthread_cond_destroy(&prefetch->wake);
+    pthread_mutex_destroy(&prefetch->lock);
+    free(prefetch);
+    sptr->prefetch = NULL;
+}
+
+/*  Drops a span of the file from the page cache once read, for
+ *  handles with the ACCESS_ONCE pattern. Pages still mapped are
+ *  skipped by the kernel, so mapped handles unmap them first.
+ */
+static void ser_release_span(serfile* sptr, uint64_t offset, size_t size) {
+    if (sptr->access_pattern != ACCESS_ONCE) {
+        return;
+    }
+    if (sptr->reader == ser_map_read) {
+        serMap* map_io = (serMap*)sptr->io_context;
+        uint64_t page_size = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t start = offset - offset % page_size;
+#if defined(MADV_DONTNEED)
+        madvise(map_io->data + start, size + (offset - start), MADV_DONTNEED);
+#else
+        posix_madvise(map_io->data + start, size + (offset - start), POSIX_MADV_DONTNEED);
+#endif
+    }
+#if defined(POSIX_FADV_DONTNEED)
+    int fd = ser_backend_fd(sptr);
+    if (fd >= 0) {
+        posix_fadvise(fd, (off_t)offset, (off_t)size, POSIX_FADV_DONTNEED);
+    }
+#else
+    (void)offset; (void)size;
+#endif
+}
+
+/* 
+ *  Timestamps shared between a handle and its clones, see 
+ *  ser_clone_handle. The array is immutable once shared and is
+ *  freed with the last handle that references it.
+ */
+typedef struct serShared {
+    pthread_mutex_t lock;
+    size_t          refs;
+    int64_t*        timestamps;
+} serShared;
+
+/*  Adds a reference to the timestamps of sptr, moving them into a
+ *  shared block on first use. Returns false if allocation fails.
+ */
+static bool ser_share_timestamps(serfile* sptr) {
+    serShared* shared = sptr->shared;
+    if (!shared) {
+        shared = (serShared*)malloc(sizeof(serShared));
+        if (!shared) {
+            return false;
+        }
+        pthread_mutex_init(&shared->lock, NULL);
+        shared->refs = 1;
+        shared->timestamps = sptr->timestamps;
+        sptr->shared = shared;
+    }
+
+    pthread_mutex_lock(&shared->lock);
+    shared->refs += 1;
+    pthread_mutex_unlock(&shared->lock);
+    return true;
+}
+#endif
+
+/*  Frees the timestamps of sptr, or drops its reference to them
+ *  when they are shared with clones.
+ */
+static void ser_release_timestamps(serfile* sptr) {
+#if defined(CSERIO_POSIX)
+    serShared* shared = sptr->shared;
+    if (shared) {
+        pthread_mutex_lock(&shared->lock);
+        bool last = --shared->refs == 0;
+        pthread_mutex_unlock(&shared->lock);
+
+        if (last) {
+            pthread_mutex_destroy(&shared->lock);
+            free(shared->timestamps);
+            free(shared);
+        }
+        sptr->shared = NULL;
+        sptr->timestamps = NULL;
+        return;
+    }
+#endif
+    free(sptr->timestamps);
+    sptr->timestamps = NULL;
+}
+
+/*  Milliseconds from a monotonic clock, for COMMIT_INTERVAL.
+ */
+static uint64_t ser_clock_ms(void) {
+#if defined(CSERIO_POSIX)
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+#else
+    return (uint64_t)clock() * 1000 / CLOCKS_PER_SEC;
+#endif
+}
+
+/*  Writes the in-memory frame count to the header.
+ */
+static bool ser_commit_frame_count(serfile* sptr) {
+    size_t bytes_written = sptr->writer(
+            sptr->io_context,
+            &sptr->frame_count,
+            FRAMECOUNT_LEN,
+            FRAMECOUNT_KEY
+    );
+    sptr->uncommitted_frames = 0;
+    sptr->committed_at = ser_clock_ms();
+    return bytes_written == FRAMECOUNT_LEN;
+}
+
+static bool ser_commit_due(serfile* sptr) {
+    switch (sptr->commit_policy) {
+        case COMMIT_FRAMES:
+            return sptr->uncommitted_frames >= sptr->commit_value;
+        case COMMIT_INTERVAL:
+            return ser_clock_ms() - sptr->committed_at >= sptr->commit_value;
+        case COMMIT_ON_FLUSH:
+            return false;
+        case COMMIT_EVERY_FRAME:
+        default:
+            return true;
+    }
+}
+
+static bool ser_grow_timestamps(serfile* sptr, size_t capacity) {
+    int64_t* new_timestamps = (int64_t*)realloc(sptr->timestamps, capacity * sizeof(int64_t));
+    if (!new_timestamps) {
+        return false;
+    }
+
+    sptr->timestamps = new_timestamps;
+    sptr->timestamp_capacity = capacity;
+    return true;
+}
+
+/*  Reads a trailer located by ser_open_initializations into memory.
+ *  Must run before anything modifies the timestamps or writes over
+ *  the trailer on disk. Returns an error code, 0 on success.
+ */
+static int ser_load_trailer(serfile* sptr) {
+    if (!sptr->trailer_pending) {
+        return NO_ERROR;
+    }
+
+    if (sptr->timestamp_count > SIZE_MAX / sizeof(int64_t)) {
+        return MEM_ALLOC;
+    }
+    size_t trailer_size = sptr->timestamp_count * sizeof(int64_t);
+    int64_t* timestamps = (int64_t*)malloc(trailer_size);
+    if (!timestamps) {
+        return MEM_ALLOC;
+    }
+
+    size_t bytes_read = sptr->reader(sptr->io_context, timestamps, trailer_size, sptr->trailer_offset);
+    if (bytes_read < trailer_size) {
+        free(timestamps);
+        return READ_ERROR;
+    }
+
+    sptr->timestamps = timestamps;
+    sptr->timestamp_capacity = sptr->timestamp_count;
+    sptr->trailer_pending = false;
+    return NO_ERROR;
+}
+
+/*  Writes the timestamps directly after the last frame.
+ */
+static bool ser_write_trailer(serfile* sptr) {
+    int status = 0;
+    unsigned long image_frame_byte_size = 0;
+    ser_get_frame_byte_size(sptr, &image_frame_byte_size, &status);
+    uint64_t image_data_size = (uint64_t)sptr->frame_count * image_frame_byte_size;
+
+    uint64_t trailer_offset = HDR_SIZE + image_data_size;
+    size_t trailer_size = sizeof(int64_t) * sptr->timestamp_count;
+
+    size_t bytes_written = sptr->writer(
+            sptr->io_context,
+            sptr->timestamps,
+            trailer_size,
+            trailer_offset
+    );
+    return bytes_written == trailer_size;
+}
+
+
+/* 
+ *  Sidecar journal of ser_set_journal, entry i is the timestamp of
+ *  frame i.
+ */
+typedef struct serJournal {
+    FILE*   file;
+    char*   path;
+    size_t  interval;
+    size_t  unsynced;
+    uint64_t entries;
+} serJournal;
+
+/*  Journals the timestamp of frame index. An entry left by an 
+ *  append that failed later is overwritten. Returns false on 
+ *  failure.
+ */
+static bool ser_journal_append(serJournal* journal, uint64_t index, int64_t timestamp) {
+    if (index != journal->entries 
+            && ser_file_seek(journal->file, index * sizeof(int64_t), SEEK_SET)) {
+        return false;
+    }
+    if (fwrite(&timestamp, sizeof(int64_t), 1, journal->file) != 1) {
+        journal->entries = UINT64_MAX;
+        return false;
+    }
+    journal->entries = index + 1;
+
+    if (++journal->unsynced >= journal->interval) {
+        journal->unsynced = 0;
+        return ser_file_flush(journal->file) == 0;
+    }
+    return true;
+}
+
+/*  Closes the journal of sptr. It is removed when discard is set 
+ *  and sptr could be flushed, as the trailer then supersedes it.
+ */
+static void ser_journal_close(serfile* sptr, bool discard) {
+    serJournal* journal = sptr->journal;
+    if (!journal) {
+        return;
+    }
+
+    fclose(journal->file);
+    if (discard && (!sptr->flusher || !sptr->flusher(sptr->io_context))) {
+        remove(journal->path);
+    }
+    free(journal->path);
+    free(journal);
+    sptr->journal = NULL;
+}
+
+/*  Appends a frame and its timestamp. Returns an error code, 0 on 
+ *  success.
+ */
+static int ser_append_frame_now(serfile* sptr, const void* data, uint64_t timestamp) {
+    int status = 0;
+    unsigned long frame_byte_size = 0;
+    ser_get_frame_byte_size(sptr, &frame_byte_size, &status);
+    if (status) { 
+        return status; 
+    }
+
+    if (frame_byte_size == 0) {
+        return INVALID_FRAME_SIZE;
+    }
+
+    /* the header stores the frame count as int32 */
+    uint64_t frame_offset = 0;
+    if (sptr->frame_count == INT32_MAX
+            || !ser_offset_of(HDR_SIZE, sptr->frame_count, frame_byte_size, &frame_offset)) {
+        return SIZE_OVERFLOW;
+    }
+
+    /* the frame lands on the trailer, so it must be in memory first */
+    if ((status = ser_load_trailer(sptr))) {
+        return status;
+    }
+
+    if (sptr->has_trailer && sptr->timestamp_count == sptr->timestamp_capacity) {
+        size_t new_capacity = ser_grown_capacity(sptr->timestamp_capacity, sptr->timestamp_count + 1);
+        if (!ser_grow_timestamps(sptr, new_capacity)) {
+            return MEM_ALLOC;
+        }
+    }
+
+    /* memory handles keep room for the trailer written on close */
+    if (sptr->has_trailer && sptr->reserver == ser_memory_reserve) {
+        serMem* memory_io = (serMem*)sptr->io_context;
+        uint64_t required = 0;
+        if (!ser_offset_of(HDR_SIZE, sptr->frame_count + 1, frame_byte_size + sizeof(int64_t), &required)
+                || required > SIZE_MAX) {
+            return SIZE_OVERFLOW;
+        }
+        if (memory_io->owns_buffer && memory_io->capacity < required) {
+            size_t new_capacity = ser_grown_capacity(memory_io->capacity, (size_t)required);
+            if (ser_memory_reserve(memory_io, new_capacity)) {
+                return MEM_ALLOC;
+            }
+        }
+    }
+
+    /* journaled first, so a frame is never counted without its entry */
+    if (sptr->has_trailer && sptr->journal
+            && !ser_journal_append(sptr->journal, sptr->timestamp_count, (int64_t)timestamp)) {
+        return JOURNAL_WRITE_ERROR;
+    }
+
+    size_t bytes_written = sptr->writer(
+            sptr->io_context,
+            data,
+            frame_byte_size,
+            frame_offset
+    );
+    if (bytes_written < frame_byte_size) {
+        return IMAGE_WRITE_WARN;
+    }
+    sptr->frame_count += 1;
+    sptr->uncommitted_frames += 1;
+    if (ser_commit_due(sptr)) {
+        ser_commit_frame_count(sptr);
+    }
+
+    if (sptr->has_trailer) {
+        sptr->timestamps[sptr->timestamp_count] = timestamp;
+        sptr->timestamp_count += 1;
+    }
+
+    return NO_ERROR;
+}
+
+#if defined(CSERIO_POSIX)
+/* 
+ *  Background writer of ser_append_frame_async. A request gives its
+ *  slot in the ring back before its completion callback runs, which
+ *  drains still wait for.
+ */
+typedef struct {
+    const void*     data;
+    uint64_t        timestamp;
+    serappendfn     done;
+    void*           user;
+} serAppendRequest;
+
+typedef struct serAppender {
+    serfile*            sptr;
+    pthread_t           thread;
+    pthread_mutex_t     lock;
+    pthread_cond_t      wake;
+    pthread_cond_t      idle;
+    serAppendRequest*   requests;
+    size_t              depth;
+    size_t              head;
+    size_t              count;
+    int                 error;
+    bool                completing;
+    bool                stopping;
+} serAppender;
+
+static void* ser_appender_worker(void* arg) {
+    serAppender* appender = (serAppender*)arg;
+
+    pthread_mutex_lock(&appender->lock);
+    for (;;) {
+        if (appender->count == 0) {
+            if (appender->stopping) {
+                break;
+            }
+            pthread_cond_wait(&appender->wake, &appender->lock);
+            continue;
+        }
+        serAppendRequest request = appender->requests[appender->head];
+        int error = appender->error;
+        pthread_mutex_unlock(&appender->lock);
+
+        /* frames queued behind a failed one are not written, so none shift into its place */
+        if (!error) {
+            error = ser_append_frame_now(appender->sptr, request.data, request.timestamp);
+        }
+
+        /* the first failure sticks until a synchronous call reports it */
+        pthread_mutex_lock(&appender->lock);
+        appender->head = (appender->head + 1) % appender->depth;
+        appender->count -= 1;
+        appender->error = error;
+
+        /* the slot is free before done runs, so done may queue the next frame */
+        if (request.done) {
+            appender->completing = true;
+            pthread_mutex_unlock(&appender->lock);
+            request.done(request.data, request.user, error);
+            pthread_mutex_lock(&appender->lock);
+            appender->completing = false;
+        }
+        pthread_cond_broadcast(&appender->idle);
+    }
+    pthread_mutex_unlock(&appender->lock);
+
+    return NULL;
+}
+
+/*  Waits until every queued asynchronous append has completed.
+ *  Returns the first error since the last call, and clears it.
+ */
+static int ser_appender_drain(serfile* sptr) {
+    serAppender* appender = sptr->appender;
+    if (!appender) {
+        return NO_ERROR;
+    }
+
+    pthread_mutex_lock(&appender->lock);
+    while (appender->count || appender->completing) {
+        pthread_cond_wait(&appender->idle, &appender->lock);
+    }
+    int error = appender->error;
+    appender->error = NO_ERROR;
+    pthread_mutex_unlock(&appender->lock);
+
+    return error;
+}
+
+/*  Completes every queued asynchronous append and stops the writer.
+ *  Returns the first error not reported yet.
+ */
+static int ser_appender_stop(serfile* sptr) {
+    serAppender* appender = sptr->appender;
+    if (!appender) {
+        return NO_ERROR;
+    }
+
+    pthread_mutex_lock(&appender->lock);
+    appender->stopping = true;
+    pthread_cond_signal(&appender->wake);
+    pthread_mutex_unlock(&appender->lock);
+    pthread_join(appender->thread, NULL);
+    int error = appender->error;
+
+    pthread_cond_destroy(&appender->idle);
+    pthread_cond_destroy(&appender->wake);
+    pthread_mutex_destroy(&appender->lock);
+    free(appender->requests);
+    free(appender);
+    sptr->appender = NULL;
+
+    return error;
+}
+#endif
+
+
+/*-------------------- Core Routines --------------------*/
+
+void cserio_version_number(int* major, int* minor, int* micro) {
+    if (major) {
+        *major = CSERIO_MAJOR;
+    }
+    if (minor) {
+        *minor = CSERIO_MINOR;
+    }
+    if (micro) {
+        *micro = CSERIO_MICRO;
+    }
+    return;
+}
+
+
+/*-------------------- SER Access Routines --------------------*/
+
+int ser_create_file(serfile** sptr, const char* path, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTRPTR(sptr, status);
+	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+
+    if (!path) {
+        return (*status = NULL_PATH);
+    }
+
+    FILE* file;
+    if ((file = fopen(path, "r"))) {
+        fclose(file);
+        return (*status = FILE_EXISTS);
+    }
+
+    file = fopen(path, "w+b");
+    if (!file) {
+        return (*status = FILE_OPEN_ERROR);
+    }
+
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
+    if (!*sptr) {
+        fclose(file);
+        return (*status = MEM_ALLOC);
+    }
+
+    (*sptr)->io_context = file;
+    (*sptr)->reader = ser_file_read;
+    (*sptr)->writer = ser_file_write;
+    (*sptr)->sizer = ser_file_size;
+    (*sptr)->flusher = ser_file_flush;
+    (*sptr)->closer = ser_file_close;
+    (*sptr)->lender = NULL;
+    (*sptr)->reserver = ser_file_reserve;
+    (*sptr)->access_mode = READWRITE;
+
+    ser_header_initializations(*sptr);
+
+    (*sptr)->has_trailer = (*sptr)->date_time <= 0 ? false : true;
+    (*sptr)->timestamps = NULL;
+    (*sptr)->timestamp_count = 0;
+
+    return (*status);
+}
+
+int ser_open_file(serfile** sptr, const char* path, int mode, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTRPTR(sptr, status);
+	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+
+    if (!path) {
+        return (*status = NULL_PATH);
+    }
+
+    FILE* file;
+    switch (mode) {
+        case READWRITE:
+            file = fopen(path, "r+b");
+            break;
+        case READFOLLOW:
+            /* the writer changes data already read, so nothing is buffered */
+            file = fopen(path, "rb");
+            if (file) {
+                setvbuf(file, NULL, _IONBF, 0);
+            }
+            break;
+        case READONLY:
+        default:
+            file = fopen(path, "rb");
+    }
+    
+    if (!file) {
+        return (*status = FILE_DNE);
+    }
+
+    /* retrieve size of file, reads are positioned explicitly */
+    uint64_t file_size = ser_file_size(file);
+
+    /* determine validity of header */
+    if (file_size < HDR_SIZE) {
+        fclose(file);
+        return (*status = INVALID_STRUCTURE);
+    }
+
+    /* allocate memory for serfile */
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
+    if (!*sptr) {
+        fclose(file);
+        return (*status = MEM_ALLOC);
+    }
+
+    /* general setup */
+    (*sptr)->io_context = file;
+    (*sptr)->reader = ser_file_read;
+    (*sptr)->writer = ser_file_write;
+    (*sptr)->sizer = ser_file_size;
+    (*sptr)->flusher = ser_file_flush;
+    (*sptr)->closer = ser_file_close;
+    (*sptr)->lender = NULL;
+    (*sptr)->reserver = ser_file_reserve;
+    (*sptr)->access_mode = mode == READWRITE ? READWRITE : READONLY;
+    (*sptr)->follow = mode == READFOLLOW;
+    (*sptr)->salvage = mode == READSALVAGE;
+
+    if (ser_open_initializations(*sptr, file_size, status)) {
+        fclose(file);
+        free((*sptr));
+        *sptr = NULL;
+    }
+
+    return (*status);
+}
+
+int ser_open_file_mapped(serfile** sptr, const char* path, int mode, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTRPTR(sptr, status);
+	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+
+    if (!path) {
+        return (*status = NULL_PATH);
+    }
+
+#if defined(CSERIO_POSIX)
+    /* a mapping has a fixed size, it cannot follow a growing file */
+    if (mode == READFOLLOW) {
+        return (*status = NOT_SUPPORTED);
+    }
+
+    bool writable = mode == READWRITE;
+    int fd = open(path, writable ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        return (*status = FILE_DNE);
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat)) {
+        close(fd);
+        return (*status = FILE_OPEN_ERROR);
+    }
+    uint64_t file_size = file_stat.st_size;
+
+    /* determine validity of header */
+    if (file_size < HDR_SIZE) {
+        close(fd);
+        return (*status = INVALID_STRUCTURE);
+    }
+
+    /* the whole file must fit in the address space */
+    if (file_size > SIZE_MAX) {
+        close(fd);
+        return (*status = FILE_OPEN_ERROR);
+    }
+
+    void* data = mmap(
+            NULL,
+            (size_t)file_size,
+            writable ? PROT_READ | PROT_WRITE : PROT_READ,
+            MAP_SHARED,
+            fd,
+            0
+    );
+    if (data == MAP_FAILED) {
+        close(fd);
+        return (*status = FILE_OPEN_ERROR);
+    }
+
+    /* allocate mapping reference and serfile */
+    serMap* map_io = (serMap*)malloc(sizeof(serMap));
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
+    if (!map_io || !*sptr) {
+        munmap(data, (size_t)file_size);
+        close(fd);
+        free(map_io);
+        free(*sptr);
+        *sptr = NULL;
+        return (*status = MEM_ALLOC);
+    }
+    map_io->fd = fd;
+    map_io->data = (uint8_t*)data;
+    map_io->size = (size_t)file_size;
+    map_io->capacity = (size_t)file_size;
+    map_io->writable = writable;
+
+    /* general setup */
+    (*sptr)->io_context = map_io;
+    (*sptr)->reader = ser_map_read;
+    (*sptr)->writer = ser_map_write;
+    (*sptr)->sizer = ser_map_size;
+    (*sptr)->flusher = ser_map_flush;
+    (*sptr)->closer = ser_map_close;
+    (*sptr)->lender = ser_map_lend;
+    (*sptr)->reserver = ser_map_reserve;
+    (*sptr)->access_mode = writable ? READWRITE : READONLY;
+    (*sptr)->salvage = mode == READSALVAGE;
+
+    if (ser_open_initializations(*sptr, file_size, status)) {
+        ser_map_close(map_io);
+        free((*sptr));
+        *sptr = NULL;
+    }
+
+    return (*status);
+#else
+    (void)mode;
+    return (*status = NOT_SUPPORTED);
+#endif
+}
+
+int ser_open_file_positional(serfile** sptr, const char* path, int mode, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTRPTR(sptr, status);
+	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+
+    if (!path) {
+        return (*status = NULL_PATH);
+    }
+
+#if defined(CSERIO_POSIX)
+    int fd = open(path, mode == READWRITE ? O_RDWR : O_RDONLY);
+    if (fd < 0) {
+        return (*status = FILE_DNE);
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat)) {
+        close(fd);
+        return (*status = FILE_OPEN_ERROR);
+    }
+    uint64_t file_size = file_stat.st_size;
+
+    /* determine validity of header */
+    if (file_size < HDR_SIZE) {
+        close(fd);
+        return (*status = INVALID_STRUCTURE);
+    }
+
+    /* allocate descriptor reference and serfile */
+    int* fd_io = (int*)malloc(sizeof(int));
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
+    if (!fd_io || !*sptr) {
+        close(fd);
+        free(fd_io);
+        free(*sptr);
+        *sptr = NULL;
+        return (*status = MEM_ALLOC);
+    }
+    *fd_io = fd;
+
+    /* general setup */
+    (*sptr)->io_context = fd_io;
+    (*sptr)->reader = ser_fd_read;
+    (*sptr)->writer = ser_fd_write;
+    (*sptr)->sizer = ser_fd_size;
+    (*sptr)->flusher = ser_fd_flush;
+    (*sptr)->closer = ser_fd_close;
+    (*sptr)->lender = NULL;
+    (*sptr)->reserver = ser_fd_reserve;
+    (*sptr)->access_mode = mode == READWRITE ? READWRITE : READONLY;
+    (*sptr)->follow = mode == READFOLLOW;
+    (*sptr)->salvage = mode == READSALVAGE;
+
+    if (ser_open_initializations(*sptr, file_size, status)) {
+        ser_fd_close(fd_io);
+        free((*sptr));
+        *sptr = NULL;
+    }
+
+    return (*status);
+#else
+    (void)mode;
+    return (*status = NOT_SUPPORTED);
+#endif
+}
+
+int ser_create_file_direct(serfile** sptr, const char* path, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTRPTR(sptr, status);
+	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+
+    if (!path) {
+        return (*status = NULL_PATH);
+    }
+
+#if defined(CSERIO_POSIX)
+    int fd = open(path, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return (*status = errno == EEXIST ? FILE_EXISTS : FILE_OPEN_ERROR);
+    }
+
+    /* allocate staging reference and serfile */
+    serDirect* direct_io = ser_direct_attach(path, fd);
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
+    if (!direct_io || !*sptr) {
+        if (direct_io) {
+            ser_direct_close(direct_io);
+        } else {
+            close(fd);
+        }
+        free(*sptr);
+        *sptr = NULL;
+        return (*status = MEM_ALLOC);
+    }
+
+    (*sptr)->io_context = direct_io;
+    (*sptr)->reader = ser_direct_read;
+    (*sptr)->writer = ser_direct_write;
+    (*sptr)->sizer = ser_direct_size;
+    (*sptr)->flusher = ser_direct_flush;
+    (*sptr)->closer = ser_direct_close;
+    (*sptr)->lender = NULL;
+    (*sptr)->reserver = ser_direct_reserve;
+    (*sptr)->access_mode = READWRITE;
+
+    ser_header_initializations(*sptr);
+
+    (*sptr)->has_trailer = (*sptr)->date_time <= 0 ? false : true;
+    (*sptr)->timestamps = NULL;
+    (*sptr)->timestamp_count = 0;
+
+    return (*status);
+#else
+    return (*status = NOT_SUPPORTED);
+#endif
+}
+
+int ser_open_file_direct(serfile** sptr, const char* path, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTRPTR(sptr, status);
+	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+
+    if (!path) {
+        return (*status = NULL_PATH);
+    }
+
+#if defined(CSERIO_POSIX)
+    int fd = open(path, O_RDWR);
+    if (fd < 0) {
+        return (*status = FILE_DNE);
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat)) {
+        close(fd);
+        return (*status = FILE_OPEN_ERROR);
+    }
+    uint64_t file_size = file_stat.st_size;
+
+    /* determine validity of header */
+    if (file_size < HDR_SIZE) {
+        close(fd);
+        return (*status = INVALID_STRUCTURE);
+    }
+
+    /* allocate staging reference and serfile */
+    serDirect* direct_io = ser_direct_attach(path, fd);
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
+    if (!direct_io || !*sptr) {
+        if (direct_io) {
+            ser_direct_close(direct_io);
+        } else {
+            close(fd);
+        }
+        free(*sptr);
+        *sptr = NULL;
+        return (*status = MEM_ALLOC);
+    }
+    direct_io->size = file_size;
+
+    /* general setup */
+    (*sptr)->io_context = direct_io;
+    (*sptr)->reader = ser_direct_read;
+    (*sptr)->writer = ser_direct_write;
+    (*sptr)->sizer = ser_direct_size;
+    (*sptr)->flusher = ser_direct_flush;
+    (*sptr)->closer = ser_direct_close;
+    (*sptr)->lender = NULL;
+    (*sptr)->reserver = ser_direct_reserve;
+    (*sptr)->access_mode = READWRITE;
+
+    /* stage the tail of the file so reads and appends see it */
+    if (!ser_direct_reposition(direct_io, file_size)) {
+        *status = FILE_OPEN_ERROR;
+    }
+
+    if (*status || ser_open_initializations(*sptr, file_size, status)) {
+        ser_direct_close(direct_io);
+        free((*sptr));
+        *sptr = NULL;
+        return (*status);
+    }
+
+    /* appends overwrite the trailer, so stage from the end of the frames */
+    if ((*sptr)->has_trailer) {
+        unsigned long frame_byte_size = 0;
+        ser_get_frame_byte_size(*sptr, &frame_byte_size, status);
+        if (!ser_direct_reposition(direct_io, HDR_SIZE + (uint64_t)(*sptr)->frame_count * frame_byte_size)) {
+            ser_direct_close(direct_io);
+            free((*sptr));
+            *sptr = NULL;
+            return (*status = FILE_OPEN_ERROR);
+        }
+    }
+
+    return (*status);
+#else
+    return (*status = NOT_SUPPORTED);
+#endif
+}
+
+int ser_close_file(serfile* sptr, int* status) {
+	RETURN_IF_NULL_SPTR(sptr, status);
+
+#if defined(CSERIO_POSIX)
+    ser_prefetch_stop(sptr);
+    int append_error = ser_appender_stop(sptr);
+    if (append_error) {
+        *status = append_error;
+    }
+#endif
+
+    bool durable = true;
+    if (sptr->uncommitted_frames && !ser_commit_frame_count(sptr)) {
+        *status = FILE_CLOSE_ERROR;
+        durable = false;
+    }
+
+    if (sptr->timestamps && sptr->access_mode == READWRITE) {
+        if (!ser_write_trailer(sptr)) {
+            *status = TRAILER_CLOSE_WARN;
+            durable = false;
+        }
+    }
+    ser_release_timestamps(sptr);
+    ser_journal_close(sptr, durable);
+
+#if defined(CSERIO_POSIX)
+    /* give back reserved blocks that were never written */
+    if (sptr->reserved && (sptr->reader == ser_file_read || sptr->reader == ser_fd_read)) {
+        uint64_t file_size = sptr->sizer(sptr->io_context);
+        if (ftruncate(ser_backend_fd(sptr), (off_t)file_size)) {
+            *status = FILE_CLOSE_ERROR;
+        }
+    }
+#endif
+
+    if (!sptr->io_context || (sptr->closer && sptr->closer(sptr->io_context))) {
+        *status = FILE_CLOSE_ERROR;
+    }
+
+    free(sptr);
+    sptr = NULL;
+    return (*status);
+}
+
+/*-------------------- Probe Routines --------------------*/
+
+int ser_probe(const char* path, serinfo* info, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    RETURN_IF_NULL_PARAM(info, status);
+
+    if (!path) {
+        return (*status = NULL_PATH);
+    }
+
+    memset(info, 0, sizeof(serinfo));
+
+    uint8_t header[HDR_SIZE];
+    size_t bytes_read = 0;
+#if defined(CSERIO_POSIX)
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return (*status = FILE_DNE);
+    }
+
+    struct stat file_stat;
+    if (fstat(fd, &file_stat)) {
+        close(fd);
+        return (*status = FILE_OPEN_ERROR);
+    }
+    info->file_size = file_stat.st_size;
+
+    if (info->file_size >= HDR_SIZE) {
+        bytes_read = ser_fd_read(&fd, header, HDR_SIZE, 0);
+    }
+    close(fd);
+#else
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return (*status = FILE_DNE);
+    }
+
+    info->file_size = ser_file_size(file);
+    if (info->file_size >= HDR_SIZE) {
+        bytes_read = ser_file_read(file, header, HDR_SIZE, 0);
+    }
+    fclose(file);
+#endif
+
+    /* too short to hold a header, nothing to describe */
+    if (info->file_size < HDR_SIZE) {
+        return (*status);
+    }
+    if (bytes_read != HDR_SIZE) {
+        return (*status = READ_ERROR);
+    }
+
+    serfile sptr;
+    memset(&sptr, 0, sizeof(serfile));
+    ser_header_decode(&sptr, header);
+
+    memcpy(info->file_id,       sptr.file_id,       FILEID_LEN);
+    info->lu_id =               sptr.lu_id;
+    info->color_id =            sptr.color_id;
+    info->little_endian =       sptr.little_endian;
+    info->image_width =         sptr.image_width;
+    info->image_height =        sptr.image_height;
+    info->pixel_depth_per_plane = sptr.pixel_depth_per_plane;
+    info->frame_count =         sptr.frame_count;
+    memcpy(info->observer,      sptr.observer,      OBSERVER_LEN);
+    memcpy(info->instrument,    sptr.instrument,    INSTRUMENT_LEN);
+    memcpy(info->telescope,     sptr.telescope,     TELESCOPE_LEN);
+    info->date_time =           sptr.date_time;
+    info->date_time_utc =       sptr.date_time_utc;
+
+    int size_status = 0;
+    ser_get_bytes_per_pixel(&sptr, &info->bytes_per_pixel, &size_status);
+    ser_get_frame_byte_size(&sptr, &info->frame_byte_size, &size_status);
+    if (size_status) {
+        info->frame_byte_size = 0;
+    }
+
+    uint64_t trailer_offset = 0;
+    info->valid = ser_structure_valid(&sptr, info->file_size, &trailer_offset);
+    info->has_trailer = info->valid && sptr.date_time > 0;
+
+    return (*status);
+}
+
+/*-------------------- Clone Routines --------------------*/
+
+int ser_clone_handle(serfile* sptr, serfile** clone, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_NULL_SPTRPTR(clone, status);
+	RETURN_IF_SPTR_OCCUPIED(clone, status);
+
+#if defined(CSERIO_POSIX)
+    /* only a handle that can no longer change is shared */
+    int source_fd = ser_backend_fd(sptr);
+    if (sptr->access_mode != READONLY || sptr->follow || source_fd < 0) {
+        return (*status = NOT_SUPPORTED);
+    }
+
+    if ((*status = ser_load_trailer(sptr))) {
+        return (*status);
+    }
+
+    /* allocate descriptor reference and serfile */
+    int* fd_io = (int*)malloc(sizeof(int));
+    *clone = (serfile*)malloc(sizeof(serfile));
+    if (!fd_io || !*clone) {
+        free(fd_io);
+        free(*clone);
+        *clone = NULL;
+        return (*status = MEM_ALLOC);
+    }
+
+    *fd_io = dup(source_fd);
+    if (*fd_io < 0) {
+        free(fd_io);
+        free(*clone);
+        *clone = NULL;
+        return (*status = FILE_OPEN_ERROR);
+    }
+
+    if (sptr->timestamps && !ser_share_timestamps(sptr)) {
+        close(*fd_io);
+        free(fd_io);
+        free(*clone);
+        *clone = NULL;
+        return (*status = MEM_ALLOC);
+    }
+
+    /* header and trailer state carry over, the backend does not */
+    memcpy(*clone, sptr, sizeof(serfile));
+    (*clone)->io_context = fd_io;
+    (*clone)->reader = ser_fd_read;
+    (*clone)->writer = ser_fd_write;
+    (*clone)->sizer = ser_fd_size;
+    (*clone)->flusher = ser_fd_flush;
+    (*clone)->closer = ser_fd_close;
+    (*clone)->lender = NULL;
+    (*clone)->reserver = NULL;
+    (*clone)->reserved = false;
+    (*clone)->access_mode = READONLY;
+    (*clone)->access_pattern = ACCESS_NORMAL;
+    (*clone)->prefetch = NULL;
+    (*clone)->appender = NULL;
+    (*clone)->uncommitted_frames = 0;
+    (*clone)->journal = NULL;
+
+    return (*status);
+#else
+    return (*status = NOT_SUPPORTED);
+#endif
+}
+
+/*-------------------- Follow Routines --------------------*/
+
+int ser_refresh(serfile* sptr, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+
+    if (!sptr->follow) {
+        return (*status = NOT_SUPPORTED);
+    }
+
+    /* the writer may still set up the header until the first frame */
+    if (sptr->frame_count == 0) {
+        uint8_t header[HDR_SIZE];
+        if (sptr->reader(sptr->io_context, header, HDR_SIZE, 0) != HDR_SIZE) {
+            return (*status = READ_ERROR);
+        }
+        ser_header_decode(sptr, header);
+        sptr->has_trailer = sptr->date_time <= 0 ? false : true;
+    } else {
+        int32_t frame_count = 0;
+        if (sptr->reader(sptr->io_context, &frame_count, FRAMECOUNT_LEN, FRAMECOUNT_KEY) != FRAMECOUNT_LEN) {
+            return (*status = READ_ERROR);
+        }
+        if (frame_count < sptr->frame_count) {
+            return (*status = INVALID_STRUCTURE);
+        }
+        sptr->frame_count = frame_count;
+    }
+
+    /* appends overwrite the trailer, it is located again */
+    ser_release_timestamps(sptr);
+    return (*status = ser_follow_locate(sptr, sptr->sizer(sptr->io_context)));
+}
+
+/*-------------------- Header Routines --------------------*/
+
+int ser_read_rec_count(serfile* sptr, int* rec_count, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_PARAM(rec_count, status);
+    *rec_count = HDR_UNIT_COUNT;
+    return (*status);
+}
+
+int ser_read_file_id(serfile* sptr, char* file_id, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(file_id, status);
+    sptr->reader(sptr->io_context, sptr->file_id, FILEID_LEN, FILEID_KEY);
+    memcpy(file_id, sptr->file_id, FILEID_LEN);
+    return (*status);
+}
+
+int ser_read_lu_id(serfile* sptr, int32_t* lu_id, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(lu_id, status);
+    sptr->reader(sptr->io_context, &sptr->lu_id, LUID_LEN, LUID_KEY); 
+    *lu_id = sptr->lu_id;
+    return (*status);
+}
+
+int ser_read_color_id(serfile* sptr, int32_t* color_id, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(color_id, status);
+    sptr->reader(sptr->io_context, &sptr->color_id, COLORID_LEN, COLORID_KEY); 
+    *color_id = sptr->color_id;
+    return (*status);
+}
+
+int ser_read_little_endian(serfile* sptr, int32_t* little_endian, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(little_endian, status);
+    sptr->reader(sptr->io_context, &sptr->little_endian, LITTLEENDIAN_LEN, LITTLEENDIAN_KEY); 
+    *little_endian = sptr->little_endian;
+    return (*status);
+}
+
+int ser_read_image_width(serfile* sptr, int32_t* image_width, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(image_width, status);
+    sptr->reader(sptr->io_context, &sptr->image_width, IMAGEWIDTH_LEN, IMAGEWIDTH_KEY); 
+    *image_width = sptr->image_width;
+    return (*status);
+}
+
+int ser_read_image_height(serfile* sptr, int32_t* image_height, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(image_height, status);
+    sptr->reader(sptr->io_context, &sptr->image_height, IMAGEHEIGHT_LEN, IMAGEHEIGHT_KEY); 
+    *image_height = sptr->image_height;
+    return (*status);
+}
+
+int ser_read_pixel_depth_per_plane(serfile* sptr, int32_t* pixel_depth_per_plane, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(pixel_depth_per_plane, status);
+    sptr->reader(sptr->io_context, &sptr->pixel_depth_per_plane, PIXELDEPTHPERPLANE_LEN, PIXELDEPTHPERPLANE_KEY); 
+    *pixel_depth_per_plane = sptr->pixel_depth_per_plane;
+    return (*status);
+}
+
+int ser_read_frame_count(serfile* sptr, int32_t* frame_count, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(frame_count, status);
+    /* follow handles only move on in ser_refresh, salvaged counts are inferred */
+    if (!sptr->follow && !sptr->salvage) {
+        sptr->reader(sptr->io_context, &sptr->frame_count, FRAMECOUNT_LEN, FRAMECOUNT_KEY); 
+    }
+    *frame_count = sptr->frame_count;
+    return (*status);
+}
+
+int ser_read_observer(serfile* sptr, char* observer, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(observer, status);
+    sptr->reader(sptr->io_context, sptr->observer, OBSERVER_LEN, OBSERVER_KEY); 
+    memcpy(observer, sptr->observer, OBSERVER_LEN);
+    return (*status);
+}
+
+int ser_read_instrument(serfile* sptr, char* instrument, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(instrument, status);
+    sptr->reader(sptr->io_context, sptr->instrument, INSTRUMENT_LEN, INSTRUMENT_KEY); 
+    memcpy(instrument, sptr->instrument, INSTRUMENT_LEN);
+    return (*status);
+}
+
+int ser_read_telescope(serfile* sptr, char* telescope, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(telescope, status);
+    sptr->reader(sptr->io_context, sptr->telescope, TELESCOPE_LEN, TELESCOPE_KEY); 
+    memcpy(telescope, sptr->telescope, TELESCOPE_LEN);
+    return (*status);
+}
+
+int ser_read_date_time(serfile* sptr, int64_t* date_time, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(date_time, status);
+    sptr->reader(sptr->io_context, &sptr->date_time, DATETIME_LEN, DATETIME_KEY); 
+    *date_time = sptr->date_time;
+    return (*status);
+}
+
+int ser_read_date_time_utc(serfile* sptr, int64_t* date_time_utc, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(date_time_utc, status);
+    sptr->reader(sptr->io_context, &sptr->date_time_utc, DATETIMEUTC_LEN, DATETIMEUTC_KEY); 
+    *date_time_utc = sptr->date_time_utc;
+    return (*status);
+}
+
+int ser_write_file_id(serfile* sptr, const char* file_id, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_PARAM(file_id, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    memcpy(sptr->file_id, file_id, FILEID_LEN);
+    sptr->writer(sptr->io_context, sptr->file_id, FILEID_LEN, FILEID_KEY);
+    return (*status);
+}
+
+int ser_write_lu_id(serfile* sptr, const int32_t lu_id, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    sptr->lu_id = lu_id;
+    sptr->writer(sptr->io_context, &sptr->lu_id, LUID_LEN, LUID_KEY);
+    return (*status);
+}
+
+int ser_write_color_id(serfile* sptr, const int32_t color_id, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+
+    /* valid color id value */
+    switch (color_id) {
+		case MONO:
+		case BAYER_RGGB:
+		case BAYER_GRBG:
+		case BAYER_GBRG:
+		case BAYER_BGGR:
+		case BAYER_CYYM:
+		case BAYER_YCMY:
+		case BAYER_YMCY:
+		case BAYER_MYYC:
+		case RGB:
+		case BGR:
+            break;
+        default:
+            return (*status = INVALID_SET_VALUE);
+    }
+
+    /* check for switch between 1 byte and 3 byte color ids */
+    if (sptr->frame_count > 0) {
+        if (sptr->color_id < 100 && color_id >= 100) {
+            return (*status = INVALID_SET_STATE);
+        }
+        if (sptr->color_id >= 100 && color_id < 100) {
+            return (*status = INVALID_SET_STATE);
+        }
+    }
+
+    sptr->color_id = color_id;
+    sptr->writer(sptr->io_context, &sptr->color_id, COLORID_LEN, COLORID_KEY);
+
+    return (*status);
+}
+
+int ser_write_little_endian(serfile* sptr, const int32_t little_endian, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+
+    if (little_endian == LITTLEENDIAN_TRUE || little_endian == LITTLEENDIAN_FALSE) {
+        sptr->little_endian = little_endian;
+        sptr->writer(sptr->io_context, &sptr->little_endian, LITTLEENDIAN_LEN, LITTLEENDIAN_KEY);
+        return (*status);
+    }
+
+    return (*status = INVALID_SET_VALUE);
+}
+
+int ser_write_image_width(serfile* sptr, const uint32_t image_width, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+
+    if (sptr->frame_count > 0) {
+        return (*status = INVALID_SET_STATE);
+    }
+
+    sptr->image_width = image_width;
+    sptr->writer(sptr->io_context, &sptr->image_width, IMAGEWIDTH_LEN, IMAGEWIDTH_KEY);
+
+    return (*status);
+}
+
+int ser_write_image_height(serfile* sptr, const uint32_t image_height, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+
+    if (sptr->frame_count > 0) {
+        return (*status = INVALID_SET_STATE);
+    }
+
+    sptr->image_height = image_height;
+    sptr->writer(sptr->io_context, &sptr->image_height, IMAGEHEIGHT_LEN, IMAGEHEIGHT_KEY);
+
+    return (*status);
+}
+
+int ser_write_pixel_depth_per_plane(serfile* sptr, const int32_t pixel_depth_per_plane, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+
+    /* pdpp must between a value from 1 - 16 */
+    if (16 < pixel_depth_per_plane || pixel_depth_per_plane <= 0) {
+        return (*status = INVALID_SET_VALUE);
+    }
+
+    /* if frames present, pdpp cannot switch between 1 and 2 bytes */
+    if (sptr->frame_count > 0) {
+        if (sptr->pixel_depth_per_plane <= 8 && pixel_depth_per_plane > 8) {
+            return (*status = INVALID_SET_STATE);
+        }
+        if (sptr->pixel_depth_per_plane > 8 && pixel_depth_per_plane <= 8) {
+            return (*status = INVALID_SET_STATE);
+        }
+    }
+
+    sptr->pixel_depth_per_plane = pixel_depth_per_plane;
+    sptr->writer(sptr->io_context, &sptr->pixel_depth_per_plane, PIXELDEPTHPERPLANE_LEN, PIXELDEPTHPERPLANE_KEY);
+
+    return (*status);
+}
+
+int ser_write_observer(serfile* sptr, const char* observer, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    RETURN_IF_NULL_PARAM(observer, status);
+    memcpy(sptr->observer, observer, OBSERVER_LEN);
+    sptr->writer(sptr->io_context, sptr->observer, OBSERVER_LEN, OBSERVER_KEY);
+    return (*status);
+}
+
+int ser_write_instrument(serfile* sptr, const char* instrument, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    RETURN_IF_NULL_PARAM(instrument, status);
+    memcpy(sptr->instrument, instrument, INSTRUMENT_LEN);
+    sptr->writer(sptr->io_context, sptr->instrument, INSTRUMENT_LEN, INSTRUMENT_KEY);
+    return (*status);
+}
+
+int ser_write_telescope(serfile* sptr, const char* telescope, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    RETURN_IF_NULL_PARAM(telescope, status);
+    memcpy(sptr->telescope, telescope, TELESCOPE_LEN);
+    sptr->writer(sptr->io_context, sptr->telescope, TELESCOPE_LEN, TELESCOPE_KEY);
+    return (*status);
+}
+
+int ser_write_date_time(serfile* sptr, const int64_t date_time, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+
+    /* if frames are present and the new data_time would change trailer state, fail */
+    if (sptr->frame_count > 0) {
+        /* has trailer -> no trailer */
+        if (sptr->date_time > 0 && date_time <= 0) {
+            return (*status = INVALID_SET_STATE);
+        }
+        /* no trailer -> has trailer */
+        if (sptr->date_time <= 0 && date_time > 0) {
+            return (*status = INVALID_SET_STATE);
+        }
+    }
+
+    sptr->date_time = date_time;
+    sptr->has_trailer = sptr->date_time <= 0 ? false : true;
+    sptr->writer(sptr->io_context, &sptr->date_time, DATETIME_LEN, DATETIME_KEY);
+
+    return (*status);
+}
+
+int ser_write_date_time_utc(serfile* sptr, const int64_t date_time_utc, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    sptr->date_time_utc = date_time_utc;
+    sptr->writer(sptr->io_context, &sptr->date_time_utc, DATETIMEUTC_LEN, DATETIMEUTC_KEY);
+    return (*status);
+}
+
+
+/*-------------------- Image Routines --------------------*/
+
+int ser_get_number_of_planes(serfile* sptr, int* nop, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_PARAM(nop, status);
+    *nop = sptr->color_id < 100 ? 1 : 3;
+    return (*status);
+}
+
+int ser_get_bytes_per_pixel(serfile* sptr, unsigned long* bytes_per_pixel, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_PARAM(bytes_per_pixel, status);
+
+    int number_of_planes = sptr->color_id < 100 ? 1 : 3;
+    int pixel_depth = sptr->pixel_depth_per_plane;
+
+    if (pixel_depth <= 8) {
+        *bytes_per_pixel = number_of_planes; /* 1 byte per pixel */
+    } else {
+        *bytes_per_pixel = number_of_planes * 2; /* 2 bytes per pixel */
+    }
+
+    return (*status);
+}
+
+int ser_get_frame_byte_size(serfile* sptr, unsigned long* byte_size, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_PARAM(byte_size, status);
+
+    unsigned long bytes_per_pixel = 0;
+    ser_get_bytes_per_pixel(sptr, &bytes_per_pixel, status);
+    if (*status) { 
+        return (*status);
+    }
+
+    /* width and height are bounded by int32, the product is not */
+    uint64_t pixels = (uint64_t)(uint32_t)sptr->image_width * (uint32_t)sptr->image_height;
+    if (pixels > UINT64_MAX / bytes_per_pixel) {
+        return (*status = SIZE_OVERFLOW);
+    }
+
+    uint64_t frame_byte_size = pixels * bytes_per_pixel;
+    if (frame_byte_size > ULONG_MAX || frame_byte_size > SIZE_MAX) {
+        return (*status = SIZE_OVERFLOW);
+    }
+
+    *byte_size = (unsigned long)frame_byte_size;
+
+    return (*status);
+}
+
+int ser_read_frame(serfile* sptr, void* dest, size_t idx, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(dest, status);
+
+    uint64_t frame_offset = 0;
+    size_t frame_byte_size = 0;
+    if (ser_frame_span(sptr, idx, 1, &frame_offset, &frame_byte_size, status)) {
+        return (*status);
+    }
+
+    size_t bytes_read = sptr->reader(sptr->io_context, dest, frame_byte_size, frame_offset);
+    if (bytes_read < frame_byte_size) {
+        return (*status = READ_ERROR);
+    }
+
+#if defined(CSERIO_POSIX)
+    ser_release_span(sptr, frame_offset, frame_byte_size);
+    if (sptr->prefetch) {
+        ser_prefetch_advance(sptr, idx + 1);
+    }
+#endif
+
+    return (*status);
+}
+
+int ser_read_frames(serfile* sptr, void* dest, size_t first, size_t count, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(dest, status);
+
+    uint64_t range_offset = 0;
+    size_t range_byte_size = 0;
+    if (ser_frame_span(sptr, first, count, &range_offset, &range_byte_size, status)) {
+        return (*status);
+    }
+
+    size_t bytes_read = sptr->reader(sptr->io_context, dest, range_byte_size, range_offset);
+    if (bytes_read < range_byte_size) {
+        return (*status = READ_ERROR);
+    }
+
+#if defined(CSERIO_POSIX)
+    ser_release_span(sptr, range_offset, range_byte_size);
+    if (sptr->prefetch) {
+        ser_prefetch_advance(sptr, first + count);
+    }
+#endif
+
+    return (*status);
+}
+
+int ser_get_frame_ptr(serfile* sptr, size_t idx, const void** out, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(out, status);
+
+    if (!sptr->lender) {
+        return (*status = NOT_SUPPORTED);
+    }
+
+    uint64_t frame_offset = 0;
+    size_t frame_byte_size = 0;
+    if (ser_frame_span(sptr, idx, 1, &frame_offset, &frame_byte_size, status)) {
+        return (*status);
+    }
+
+    const void* frame = sptr->lender(sptr->io_context, frame_byte_size, frame_offset);
+    if (!frame) {
+        return (*status = READ_ERROR);
+    }
+
+    *out = frame;
+    return (*status);
+}
+
+int ser_append_frame(serfile* sptr, const void* data, uint64_t timestamp, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    RETURN_IF_NULL_PARAM(data, status);
+
+#if defined(CSERIO_POSIX)
+    /* frames still queued by ser_append_frame_async go first */
+    if ((*status = ser_appender_drain(sptr))) {
+        return (*status);
+    }
+#endif
+
+    return (*status = ser_append_frame_now(sptr, data, timestamp));
+}
+
+int ser_get_append_buffer(serfile* sptr, void** buffer, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(buffer, status);
+
+#if defined(CSERIO_POSIX)
+    if (sptr->writer != ser_direct_write) {
+        return (*status = NOT_SUPPORTED);
+    }
+
+    unsigned long frame_byte_size = 0;
+    ser_get_frame_byte_size(sptr, &frame_byte_size, status);
+    if (*status) { 
+        return (*status); 
+    }
+
+    if (frame_byte_size == 0) {
+        return (*status = INVALID_FRAME_SIZE);
+    }
+
+    /* the slot covers the trailer on disk, which has to be read first */
+    if ((*status = ser_load_trailer(sptr))) {
+        return (*status);
+    }
+
+    uint64_t frame_offset = HDR_SIZE + (uint64_t)frame_byte_size * sptr->frame_count;
+    uint8_t* slot = NULL;
+    if ((*status = ser_direct_slot((serDirect*)sptr->io_context, frame_offset, frame_byte_size, &slot))) {
+        return (*status);
+    }
+
+    *buffer = slot;
+    return (*status);
+#else
+    return (*status = NOT_SUPPORTED);
+#endif
+}
+
+int ser_reserve_frames(serfile* sptr, size_t count, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+
+    if (!sptr->reserver) {
+        return (*status = NOT_SUPPORTED);
+    }
+
+    unsigned long frame_byte_size = 0;
+    ser_get_frame_byte_size(sptr, &frame_byte_size, status);
+    if (*status) { 
+        return (*status); 
+    }
+
+    if (frame_byte_size == 0) {
+        return (*status = INVALID_FRAME_SIZE);
+    }
+
+    uint64_t frame_count = (uint64_t)sptr->frame_count + count;
+    uint64_t unit_size = frame_byte_size + (sptr->has_trailer ? sizeof(int64_t) : 0);
+    uint64_t reserve_size = 0;
+    if (frame_count > INT32_MAX || !ser_offset_of(HDR_SIZE, frame_count, unit_size, &reserve_size)) {
+        return (*status = SIZE_OVERFLOW);
+    }
+
+    if (sptr->reserver(sptr->io_context, reserve_size)) {
+        return (*status = RESERVE_ERROR);
+    }
+    sptr->reserved = true;
+
+    if ((*status = ser_load_trailer(sptr))) {
+        return (*status);
+    }
+
+    if (sptr->has_trailer && sptr->timestamp_capacity < frame_count) {
+        if (!ser_grow_timestamps(sptr, (size_t)frame_count)) {
+            return (*status = MEM_ALLOC);
+        }
+    }
+
+    return (*status);
+}
+
+/*-------------------- Trailer Routines --------------------*/
+
+int ser_read_timestamp(serfile* sptr, int64_t* dest, size_t idx, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(dest, status);
+
+    if (!sptr->has_trailer) {
+        return (*status = TRAILER_DNE);
+    }
+
+    if (idx >= sptr->timestamp_count) {
+        return (*status = INVALID_TRAILER_IDX); 
+    }
+
+    /* an addressable trailer is read in place, without loading it */
+    if (sptr->trailer_pending && sptr->lender) {
+        const void* timestamp = sptr->lender(
+                sptr->io_context,
+                sizeof(int64_t),
+                sptr->trailer_offset + idx * sizeof(int64_t)
+        );
+        if (timestamp) {
+            memcpy(dest, timestamp, sizeof(int64_t));
+            return (*status);
+        }
+    }
+
+#if defined(CSERIO_POSIX)
+    /* positional handles are read from several threads, so loading would race */
+    if (sptr->trailer_pending && sptr->reader == ser_fd_read) {
+        uint64_t offset = sptr->trailer_offset + idx * sizeof(int64_t);
+        if (ser_fd_read(sptr->io_context, dest, sizeof(int64_t), offset) != sizeof(int64_t)) {
+            return (*status = READ_ERROR);
+        }
+        return (*status);
+    }
+#endif
+
+    if ((*status = ser_load_trailer(sptr))) {
+        return (*status);
+    }
+
+    *dest = sptr->timestamps[idx];
+
+    return (*status);
+}
+
+/*-------------------- Access Hint Routines --------------------*/
+
+int ser_set_access_pattern(serfile* sptr, int pattern, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+
+    switch (pattern) {
+        case ACCESS_NORMAL:
+        case ACCESS_SEQUENTIAL:
+        case ACCESS_RANDOM:
+        case ACCESS_ONCE:
+            break;
+        default:
+            return (*status = INVALID_SET_VALUE);
+    }
+    sptr->access_pattern = pattern;
+
+#if defined(CSERIO_POSIX)
+    int map_advice = POSIX_MADV_NORMAL;
+    switch (pattern) {
+        case ACCESS_SEQUENTIAL:
+        case ACCESS_ONCE:
+            map_advice = POSIX_MADV_SEQUENTIAL;
+            break;
+        case ACCESS_RANDOM:
+            map_advice = POSIX_MADV_RANDOM;
+            break;
+    }
+
+    if (sptr->reader == ser_map_read) {
+        serMap* map_io = (serMap*)sptr->io_context;
+        posix_madvise(map_io->data, map_io->capacity, map_advice);
+    }
+
+#if defined(POSIX_FADV_NORMAL)
+    int file_advice = POSIX_FADV_NORMAL;
+    switch (pattern) {
+        case ACCESS_SEQUENTIAL:
+        case ACCESS_ONCE:
+            file_advice = POSIX_FADV_SEQUENTIAL;
+            break;
+        case ACCESS_RANDOM:
+            file_advice = POSIX_FADV_RANDOM;
+            break;
+    }
+
+    int fd = ser_backend_fd(sptr);
+    if (fd >= 0) {
+        posix_fadvise(fd, 0, 0, file_advice);
+    }
+#endif
+#endif
+
+    return (*status);
+}
+
+int ser_set_prefetch(serfile* sptr, size_t distance, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+
+#if defined(CSERIO_POSIX)
+    ser_prefetch_stop(sptr);
+    if (distance == 0) {
+        return (*status);
+    }
+
+#if defined(POSIX_FADV_WILLNEED)
+    int fd = ser_backend_fd(sptr);
+#else
+    int fd = -1;
+#endif
+    if (fd < 0) {
+        return (*status = NOT_SUPPORTED);
+    }
+
+    unsigned long frame_byte_size = 0;
+    ser_get_frame_byte_size(sptr, &frame_byte_size, status);
+    if (*status) {
+        return (*status);
+    }
+    if (frame_byte_size == 0) {
+        return (*status = INVALID_FRAME_SIZE);
+    }
+
+    serPrefetch* prefetch = (serPrefetch*)calloc(1, sizeof(serPrefetch));
+    if (!prefetch) {
+        return (*status = MEM_ALLOC);
+    }
+    prefetch->fd = fd;
+    prefetch->frame_byte_size = frame_byte_size;
+    prefetch->distance = distance;
+
+    pthread_mutex_init(&prefetch->lock, NULL);
+    pthread_cond_init(&prefetch->wake, NULL);
+    if (pthread_create(&prefetch->thread, NULL, ser_prefetch_worker, prefetch)) {
+        pthread_cond_destroy(&prefetch->wake);
+        pthread_mutex_destroy(&prefetch->lock);
+        free(prefetch);
+        return (*status = ASYNC_INIT_ERROR);
+    }
+
+    sptr->prefetch = prefetch;
+    ser_prefetch_advance(sptr, 0);
+    return (*status);
+#else
+    (void)distance;
+    return (*status = NOT_SUPPORTED);
+#endif
+}
+
+/*-------------------- Commit Routines --------------------*/
+
+int ser_set_commit_policy(serfile* sptr, int policy, size_t value, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+
+    switch (policy) {
+        case COMMIT_EVERY_FRAME:
+        case COMMIT_ON_FLUSH:
+            break;
+        case COMMIT_FRAMES:
+        case COMMIT_INTERVAL:
+            if (value == 0) {
+                return (*status = INVALID_SET_VALUE);
+            }
+            break;
+        default:
+            return (*status = INVALID_SET_VALUE);
+    }
+
+    sptr->commit_policy = policy;
+    sptr->commit_value = value;
+    sptr->committed_at = ser_clock_ms();
+
+    return (*status);
+}
+
+int ser_flush(serfile* sptr, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+
+#if defined(CSERIO_POSIX)
+    if ((*status = ser_appender_drain(sptr))) {
+        return (*status);
+    }
+#endif
+
+    if (!ser_commit_frame_count(sptr)) {
+        return (*status = FILE_FLUSH_ERROR);
+    }
+
+    if (sptr->timestamps && !ser_write_trailer(sptr)) {
+        return (*status = FILE_FLUSH_ERROR);
+    }
+
+    if (sptr->flusher && sptr->flusher(sptr->io_context)) {
+        return (*status = FILE_FLUSH_ERROR);
+    }
+
+    if (sptr->journal) {
+        sptr->journal->unsynced = 0;
+        if (ser_file_flush(sptr->journal->file)) {
+            return (*status = FILE_FLUSH_ERROR);
+        }
+    }
+
+    return (*status);
+}
+
+/*-------------------- Journal Routines --------------------*/
+
+int ser_set_journal(serfile* sptr, const char* path, size_t interval, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+
+    if (path && interval == 0) {
+        return (*status = INVALID_SET_VALUE);
+    }
+
+#if defined(CSERIO_POSIX)
+    if ((*status = ser_appender_drain(sptr))) {
+        return (*status);
+    }
+#endif
+
+    ser_journal_close(sptr, true);
+    if (!path) {
+        return (*status);
+    }
+
+    /* the timestamps held so far open the journal */
+    if ((*status = ser_load_trailer(sptr))) {
+        return (*status);
+    }
+
+    serJournal* journal = (serJournal*)malloc(sizeof(serJournal));
+    size_t path_size = strlen(path) + 1;
+    char* journal_path = (char*)malloc(path_size);
+    if (!journal || !journal_path) {
+        free(journal);
+        free(journal_path);
+        return (*status = MEM_ALLOC);
+    }
+    memcpy(journal_path, path, path_size);
+
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        free(journal);
+        free(journal_path);
+        return (*status = FILE_OPEN_ERROR);
+    }
+
+    size_t journaled = 0;
+    if (sptr->has_trailer && sptr->timestamp_count) {
+        journaled = fwrite(sptr->timestamps, sizeof(int64_t), sptr->timestamp_count, file);
+    }
+    if (journaled != (sptr->has_trailer ? sptr->timestamp_count : 0) || ser_file_flush(file)) {
+        fclose(file);
+        remove(path);
+        free(journal);
+        free(journal_path);
+        return (*status = JOURNAL_WRITE_ERROR);
+    }
+
+    journal->file = file;
+    journal->path = journal_path;
+    journal->interval = interval;
+    journal->unsynced = 0;
+    journal->entries = journaled;
+    sptr->journal = journal;
+
+    return (*status);
+}
+
+int ser_repair_file(const char* path, const char* journal, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+
+    if (!path) {
+        return (*status = NULL_PATH);
+    }
+
+    FILE* file = fopen(path, "r+b");
+    if (!file) {
+        return (*status = FILE_DNE);
+    }
+
+    uint8_t header[HDR_SIZE];
+    uint64_t file_size = ser_file_size(file);
+    if (file_size < HDR_SIZE || ser_file_read(file, header, HDR_SIZE, 0) != HDR_SIZE) {
+        fclose(file);
+        return (*status = INVALID_STRUCTURE);
+    }
+
+    serfile sptr;
+    memset(&sptr, 0, sizeof(serfile));
+    ser_header_decode(&sptr, header);
+    sptr.io_context = file;
+    sptr.reader = ser_file_read;
+
+    uint64_t trailer_offset = 0;
+    if (ser_structure_valid(&sptr, file_size, &trailer_offset)) {
+        fclose(file);
+        return (*status);
+    }
+
+    if (ser_salvage_locate(&sptr, file_size)) {
+        fclose(file);
+        return (*status = INVALID_STRUCTURE);
+    }
+
+    unsigned long frame_byte_size = 0;
+    ser_get_frame_byte_size(&sptr, &frame_byte_size, status);
+    uint64_t frame_count = sptr.frame_count;
+
+    /* the journal stands in for the trailer, frames it lacks are dropped */
+    FILE* journal_file = NULL;
+    if (journal && sptr.date_time > 0) {
+        if (!(journal_file = fopen(journal, "rb"))) {
+            fclose(file);
+            return (*status = FILE_DNE);
+        }
+
+        frame_count = (file_size - HDR_SIZE) / frame_byte_size;
+        uint64_t journaled = ser_file_size(journal_file) / sizeof(int64_t);
+        if (frame_count > journaled) {
+            frame_count = journaled;
+        }
+        if (frame_count > INT32_MAX) {
+            frame_count = INT32_MAX;
+        }
+    }
+
+    int64_t* timestamps = NULL;
+    size_t trailer_size = 0;
+    if (sptr.date_time > 0 && frame_count) {
+        if (frame_count > SIZE_MAX / sizeof(int64_t)
+                || !(timestamps = (int64_t*)calloc(frame_count, sizeof(int64_t)))) {
+            if (journal_file) {
+                fclose(journal_file);
+            }
+            fclose(file);
+            return (*status = MEM_ALLOC);
+        }
+        trailer_size = frame_count * sizeof(int64_t);
+
+        /* otherwise what survives of the trailer, lost timestamps are 0 */
+        size_t bytes_read = 0;
+        size_t expected = trailer_size;
+        if (journal_file) {
+            bytes_read = ser_file_read(journal_file, timestamps, trailer_size, 0);
+        } else {
+            expected = sptr.timestamp_count * sizeof(int64_t);
+            bytes_read = expected ? ser_file_read(file, timestamps, expected, sptr.trailer_offset) : 0;
+        }
+        if (bytes_read != expected) {
+            if (journal_file) {
+                fclose(journal_file);
+            }
+            free(timestamps);
+            fclose(file);
+            return (*status = READ_ERROR);
+        }
+    }
+    if (journal_file) {
+        fclose(journal_file);
+    }
+
+    sptr.frame_count = (int32_t)frame_count;
+    ser_offset_of(HDR_SIZE, frame_count, frame_byte_size, &trailer_offset);
+    uint64_t repaired_size = trailer_offset + trailer_size;
+
+#if !defined(CSERIO_POSIX)
+    /* stdio cannot shorten a file */
+    if (repaired_size != file_size) {
+        free(timestamps);
+        fclose(file);
+        return (*status = NOT_SUPPORTED);
+    }
+#endif
+
+    if (ser_file_write(file, &sptr.frame_count, FRAMECOUNT_LEN, FRAMECOUNT_KEY) != FRAMECOUNT_LEN
+            || (trailer_size && ser_file_write(file, timestamps, trailer_size, trailer_offset) != trailer_size)) {
+        *status = IMAGE_WRITE_WARN;
+    }
+    free(timestamps);
+
+#if defined(CSERIO_POSIX)
+    if (!*status && (fflush(file) || ftruncate(fileno(file), (off_t)repaired_size))) {
+        *status = IMAGE_WRITE_WARN;
+    }
+#endif
+    if (ser_file_flush(file) && !*status) {
+        *status = FILE_FLUSH_ERROR;
+    }
+    if (fclose(file) && !*status) {
+        *status = FILE_CLOSE_ERROR;
+    }
+
+    return (*status);
+}
+
+/*-------------------- Capacity Routines --------------------*/
+
+int ser_shrink_to_fit(serfile* sptr, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+
+    if (sptr->timestamp_capacity > sptr->timestamp_count) {
+        if (sptr->timestamp_count == 0) {
+            free(sptr->timestamps);
+            sptr->timestamps = NULL;
+            sptr->timestamp_capacity = 0;
+        } else if (!ser_grow_timestamps(sptr, sptr->timestamp_count)) {
+            return (*status = MEM_ALLOC);
+        }
+    }
+
+    if (sptr->reserver == ser_memory_reserve) {
+        serMem* memory_io = (serMem*)sptr->io_context;
+        if (memory_io->capacity > memory_io->size) {
+            void* new_block = realloc(memory_io->data, memory_io->size);
+            if (!new_block) {
+                return (*status = MEM_ALLOC);
+            }
+            memory_io->data = (uint8_t*)new_block;
+            memory_io->capacity = memory_io->size;
+        }
+    }
+
+    return (*status);
+}
+
+int ser_get_capacity(serfile* sptr, size_t* capacity, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_PARAM(capacity, status);
+
+    size_t frame_count = sptr->frame_count;
+    size_t frames = SIZE_MAX;
+
+    if (sptr->has_trailer) {
+        frames = sptr->timestamp_capacity;
+    }
+
+    unsigned long frame_byte_size = 0;
+    int size_status = 0;
+    ser_get_frame_byte_size(sptr, &frame_byte_size, &size_status);
+    if (sptr->reserver == ser_memory_reserve && !size_status && frame_byte_size) {
+        /* the trailer written on close takes its share of the buffer */
+        serMem* memory_io = (serMem*)sptr->io_context;
+        size_t unit_size = frame_byte_size + (sptr->has_trailer ? sizeof(int64_t) : 0);
+        size_t buffer_frames = (memory_io->capacity - HDR_SIZE) / unit_size;
+        if (buffer_frames < frames) {
+            frames = buffer_frames;
+        }
+    }
+
+    *capacity = frames == SIZE_MAX || frames < frame_count ? frame_count : frames;
+    return (*status);
+}
+
+/*-------------------- Asynchronous Read Routines --------------------*/
+
+#if defined(CSERIO_POSIX)
+
+/* 
+ *  Upper bound on the worker threads of the thread-pool engine.
+ */
+#define SER_ASYNC_MAX_WORKERS               8
+
+typedef struct {
+    void*    dest;
+    size_t   idx;
+    void*    user_data;
+    uint64_t offset;
+    size_t   size;
+#if defined(CSERIO_IO_URING)
+    size_t          done;
+    struct iovec    iov;
+#endif
+} serAsyncRequest;
+
+#if defined(CSERIO_IO_URING)
+/* 
+ *  An io_uring instance set up without liburing. Only the ring 
+ *  fields the library touches are kept; the rings are shared with
+ *  the kernel, which advances sq_head and cq_tail.
+ */
+typedef struct {
+    int                     fd;
+    int                     file_fd;
+    unsigned                sq_entries;
+    unsigned                sq_mask;
+    unsigned*               sq_head;
+    unsigned*               sq_tail;
+    unsigned*               sq_array;
+    unsigned                cq_mask;
+    unsigned*               cq_head;
+    unsigned*               cq_tail;
+    struct io_uring_sqe*    sqes;
+    struct io_uring_cqe*    cqes;
+    void*                   sq_ring;
+    size_t                  sq_ring_size;
+    void*                   cq_ring;
+    size_t                  cq_ring_size;
+    size_t                  sqes_size;
+} serRing;
+#endif
+
+struct serasync {
+    serfile*            sptr;
+    size_t              depth;
+    size_t              in_flight;
+
+    serAsyncRequest*    requests;
+    size_t*             free_slots;
+    size_t              free_count;
+
+    sercompletion*      completions;
+    size_t              completion_head;
+    size_t              completion_count;
+
+    size_t*             queue;
+    size_t              queue_head;
+    size_t              queue_count;
+
+    pthread_mutex_t     lock;
+    pthread_cond_t      queued;
+    pthread_cond_t      completed;
+    pthread_t*          workers;
+    size_t              worker_count;
+    bool                stopping;
+
+#if defined(CSERIO_IO_URING)
+    serRing*            ring;
+#endif
+};
+
+/*  Moves a finished request to the completion ring and releases
+ *  its slot. Must be called with aptr->lock held.
+ */
+static void ser_async_complete(serasync* aptr, size_t slot, int request_status) {
+    serAsyncRequest* request = &aptr->requests[slot];
+    size_t tail = (aptr->completion_head + aptr->completion_count) % aptr->depth;
+
+    aptr->completions[tail].idx = request->idx;
+    aptr->completions[tail].dest = request->dest;
+    aptr->completions[tail].user_data = request->user_data;
+    aptr->completions[tail].status = request_status;
+    aptr->completion_count += 1;
+
+    aptr->free_slots[aptr->free_count++] = slot;
+}
+
+static void* ser_async_worker(void* arg) {
+    serasync* aptr = (serasync*)arg;
+    serfile* sptr = aptr->sptr;
+
+    pthread_mutex_lock(&aptr->lock);
+    for (;;) {
+        while (!aptr->queue_count && !aptr->stopping) {
+            pthread_cond_wait(&aptr->queued, &aptr->lock);
+        }
+        if (!aptr->queue_count) {
+            break;
+        }
+
+        size_t slot = aptr->queue[aptr->queue_head];
+        aptr->queue_head = (aptr->queue_head + 1) % aptr->depth;
+        aptr->queue_count -= 1;
+        pthread_mutex_unlock(&aptr->lock);
+
+        serAsyncRequest* request = &aptr->requests[slot];
+        size_t bytes_read = sptr->reader(sptr->io_context, request->dest, request->size, request->offset);
+
+        pthread_mutex_lock(&aptr->lock);
+        ser_async_complete(aptr, slot, bytes_read < request->size ? READ_ERROR : NO_ERROR);
+        pthread_cond_signal(&aptr->completed);
+    }
+    pthread_mutex_unlock(&aptr->lock);
+
+    return NULL;
+}
+
+#if defined(CSERIO_IO_URING)
+static void ser_ring_destroy(serRing* ring) {
+    if (ring->sqes) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring) {
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+    close(ring->fd);
+    free(ring);
+}
+
+/*  Sets up a ring for depth reads of file_fd. The completion queue
+ *  is twice the submission queue, so it never overflows with depth
+ *  reads in flight. Returns NULL where io_uring is not available.
+ */
+static serRing* ser_ring_create(int file_fd, size_t depth) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    if (depth > UINT_MAX) {
+        return NULL;
+    }
+
+    serRing* ring = (serRing*)calloc(1, sizeof(serRing));
+    if (!ring) {
+        return NULL;
+    }
+
+    ring->fd = (int)syscall(__NR_io_uring_setup, (unsigned)depth, &params);
+    if (ring->fd < 0) {
+        free(ring);
+        return NULL;
+    }
+    ring->file_fd = file_fd;
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    int protection = PROT_READ | PROT_WRITE;
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, protection, MAP_SHARED, ring->fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = mmap(NULL, ring->cq_ring_size, protection, MAP_SHARED, ring->fd, IORING_OFF_CQ_RING);
+    ring->sqes = (struct io_uring_sqe*)mmap(NULL, ring->sqes_size, protection, MAP_SHARED, ring->fd, IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        ring->sq_ring = ring->sq_ring == MAP_FAILED ? NULL : ring->sq_ring;
+        ring->cq_ring = ring->cq_ring == MAP_FAILED ? NULL : ring->cq_ring;
+        ring->sqes = ring->sqes == MAP_FAILED ? NULL : ring->sqes;
+        ser_ring_destroy(ring);
+        return NULL;
+    }
+
+    uint8_t* sq_ring = (uint8_t*)ring->sq_ring;
+    ring->sq_entries = params.sq_entries;
+    ring->sq_mask = *(unsigned*)(sq_ring + params.sq_off.ring_mask);
+    ring->sq_head = (unsigned*)(sq_ring + params.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq_ring + params.sq_off.tail);
+    ring->sq_array = (unsigned*)(sq_ring + params.sq_off.array);
+
+    uint8_t* cq_ring = (uint8_t*)ring->cq_ring;
+    ring->cq_mask = *(unsigned*)(cq_ring + params.cq_off.ring_mask);
+    ring->cq_head = (unsigned*)(cq_ring + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq_ring + params.cq_off.tail);
+    ring->cqes = (struct io_uring_cqe*)(cq_ring + params.cq_off.cqes);
+
+    return ring;
+}
+
+/*  Hands the unread part of the request in slot to the kernel. 
+ *  Returns false if it could not be submitted.
+ */
+static bool ser_ring_queue(serasync* aptr, size_t slot) {
+    serRing* ring = aptr->ring;
+    serAsyncRequest* request = &aptr->requests[slot];
+
+    unsigned tail = *ring->sq_tail;
+    if (tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE) >= ring->sq_entries) {
+        return false;
+    }
+
+    request->iov.iov_base = (uint8_t*)request->dest + request->done;
+    request->iov.iov_len = request->size - request->done;
+
+    unsigned index = tail & ring->sq_mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_READV;
+    sqe->fd = ring->file_fd;
+    sqe->off = request->offset + request->done;
+    sqe->addr = (uint64_t)(uintptr_t)&request->iov;
+    sqe->len = 1;
+    sqe->user_data = slot;
+    ring->sq_array[index] = index;
+    __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+    long submitted = 0;
+    do {
+        submitted = syscall(__NR_io_uring_enter, ring->fd, 1, 0, 0, NULL, 0);
+    } while (submitted < 0 && errno == EINTR);
+
+    /* the kernel only consumes entries in io_uring_enter, so one it refused is taken back */
+    if (submitted != 1) {
+        __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+        return false;
+    }
+    return true;
+}
+
+/*  Processes the finished reads of the ring, blocking for the first
+ *  one if asked to. Short reads are resubmitted for the remaining 
+ *  bytes. Must be called with aptr->lock held. Returns false if 
+ *  waiting failed.
+ */
+static bool ser_ring_reap(serasync* aptr, bool block) {
+    serRing* ring = aptr->ring;
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+
+    while (block && head == tail) {
+        long waited = syscall(__NR_io_uring_enter, ring->fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0);
+        if (waited < 0 && errno != EINTR) {
+            return false;
+        }
+        tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    }
+
+    for (; head != tail; head++) {
+        struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+        size_t slot = (size_t)cqe->user_data;
+        int result = cqe->res;
+        serAsyncRequest* request = &aptr->requests[slot];
+
+        if (result <= 0) {
+            ser_async_complete(aptr, slot, READ_ERROR);
+            continue;
+        }
+
+        request->done += (size_t)result;
+        if (request->done < request->size) {
+            if (!ser_ring_queue(aptr, slot)) {
+                ser_async_complete(aptr, slot, READ_ERROR);
+            }
+            continue;
+        }
+        ser_async_complete(aptr, slot, NO_ERROR);
+    }
+    __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+/*  Descriptor the ring reads, or -1 if the handle has none that 
+ *  can be read behind its back.
+ */
+static int ser_ring_file_fd(serfile* sptr) {
+    if (sptr->reader == ser_fd_read) {
+        return *(int*)sptr->io_context;
+    }
+    /* a read only stream holds no buffered writes the kernel would miss */
+    if (sptr->reader == ser_file_read && sptr->access_mode == READONLY) {
+        return fileno((FILE*)sptr->io_context);
+    }
+    return -1;
+}
+#endif
+
+static void ser_async_free(serasync* aptr) {
+    free(aptr->requests);
+    free(aptr->free_slots);
+    free(aptr->completions);
+    free(aptr->queue);
+    free(aptr->workers);
+    free(aptr);
+}
+
+int ser_async_create(serasync** aptr, serfile* sptr, size_t depth, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    RETURN_IF_NULL_PARAM(aptr, status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+
+    if (depth == 0) {
+        return (*status = INVALID_ASYNC_DEPTH);
+    }
+
+    serasync* async = (serasync*)calloc(1, sizeof(serasync));
+    if (!async) {
+        return (*status = MEM_ALLOC);
+    }
+
+    async->sptr = sptr;
+    async->depth = depth;
+    async->requests = (serAsyncRequest*)malloc(depth * sizeof(serAsyncRequest));
+    async->free_slots = (size_t*)malloc(depth * sizeof(size_t));
+    async->completions = (sercompletion*)malloc(depth * sizeof(sercompletion));
+    async->queue = (size_t*)malloc(depth * sizeof(size_t));
+    if (!async->requests || !async->free_slots || !async->completions || !async->queue) {
+        ser_async_free(async);
+        return (*status = MEM_ALLOC);
+    }
+
+    for (size_t i = 0; i < depth; i++) {
+        async->free_slots[i] = depth - 1 - i;
+    }
+    async->free_count = depth;
+
+    pthread_mutex_init(&async->lock, NULL);
+    pthread_cond_init(&async->queued, NULL);
+    pthread_cond_init(&async->completed, NULL);
+
+#if defined(CSERIO_IO_URING)
+    /* the kernel keeps every read in flight, no worker is needed */
+    int file_fd = ser_ring_file_fd(sptr);
+    if (file_fd >= 0 && (async->ring = ser_ring_create(file_fd, depth))) {
+        *aptr = async;
+        return (*status);
+    }
+#endif
+
+    /* only backends without a shared cursor are read from several threads */
+    bool concurrent = sptr->reader == ser_fd_read
+        || sptr->reader == ser_map_read
+        || sptr->reader == ser_memory_read;
+    size_t worker_count = 1;
+    if (concurrent) {
+        worker_count = depth < SER_ASYNC_MAX_WORKERS ? depth : SER_ASYNC_MAX_WORKERS;
+    }
+
+    async->workers = (pthread_t*)malloc(worker_count * sizeof(pthread_t));
+    if (!async->workers) {
+        ser_async_destroy(async, status);
+        return (*status = MEM_ALLOC);
+    }
+
+    for (size_t i = 0; i < worker_count; i++) {
+        if (pthread_create(&async->workers[i], NULL, ser_async_worker, async)) {
+            ser_async_destroy(async, status);
+            return (*status = ASYNC_INIT_ERROR);
+        }
+        async->worker_count += 1;
+    }
+
+    *aptr = async;
+    return (*status);
+}
+
+int ser_async_submit(serasync* aptr, void* dest, size_t idx, void* user_data, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    RETURN_IF_NULL_PARAM(aptr, status);
+    RETURN_IF_NULL_DEST_BUFF(dest, status);
 
-static size_t ser_memory_read(void* io_context, void* buffer, size_t size, size_t offset) {
-    serMem* memory_io = (serMem*)(io_context);
+    uint64_t frame_offset = 0;
+    size_t frame_byte_size = 0;
+    if (ser_frame_span(aptr->sptr, idx, 1, &frame_offset, &frame_byte_size, status)) {
+        return (*status);
+    }
 
-    if (memory_io->size < offset) {
-        return 0;
+    pthread_mutex_lock(&aptr->lock);
+    if (aptr->in_flight == aptr->depth) {
+        pthread_mutex_unlock(&aptr->lock);
+        return (*status = ASYNC_QUEUE_FULL);
     }
 
-    if (memory_io->size < offset + size) {
-        size_t cut_size = memory_io->size - offset;
-        memcpy(buffer, memory_io->data + offset, cut_size);
-        return cut_size;
+    size_t slot = aptr->free_slots[--aptr->free_count];
+    serAsyncRequest* request = &aptr->requests[slot];
+    request->dest = dest;
+    request->idx = idx;
+    request->user_data = user_data;
+    request->offset = frame_offset;
+    request->size = frame_byte_size;
+    aptr->in_flight += 1;
+
+#if defined(CSERIO_IO_URING)
+    if (aptr->ring) {
+        request->done = 0;
+        if (!ser_ring_queue(aptr, slot)) {
+            ser_async_complete(aptr, slot, READ_ERROR);
+        }
+        pthread_mutex_unlock(&aptr->lock);
+        return (*status);
     }
+#endif
 
-    memcpy(buffer, memory_io->data + offset, size);
+    aptr->queue[(aptr->queue_head + aptr->queue_count) % aptr->depth] = slot;
+    aptr->queue_count += 1;
+    pthread_cond_signal(&aptr->queued);
+    pthread_mutex_unlock(&aptr->lock);
 
-    return size;
+    return (*status);
 }
 
-static size_t ser_memory_write(void* io_context, const void* data, size_t size, size_t offset) {
-    serMem* memory_io = (serMem*)(io_context);
+static int ser_async_collect(serasync* aptr, sercompletion* completions, size_t max, size_t* count, bool block, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    RETURN_IF_NULL_PARAM(aptr, status);
+    RETURN_IF_NULL_DEST_BUFF(completions, status);
+    RETURN_IF_NULL_PARAM(count, status);
 
-    if (!memory_io->owns_buffer) {
-        if (memory_io->size < offset) {
-            return 0;
-        }
+    pthread_mutex_lock(&aptr->lock);
 
-        if (memory_io->size < offset + size) {
-            size_t cut_size = memory_io->size - offset;
-            memcpy(memory_io->data + offset, data, cut_size);
-            return cut_size;
+#if defined(CSERIO_IO_URING)
+    if (aptr->ring) {
+        bool reaped = ser_ring_reap(aptr, false);
+        while (reaped && block && !aptr->completion_count && aptr->in_flight) {
+            reaped = ser_ring_reap(aptr, true);
         }
-    } else {
-        if (memory_io->size < offset + size) {
-            void* new_block = realloc(memory_io->data, offset + size);
-            if (new_block) {
-                memory_io->data = (uint8_t*)new_block;
-                memory_io->size = offset + size;
-            } else {
-                size_t cut_size = memory_io->size - offset;
-                memcpy(memory_io->data + offset, data, cut_size);
-                return cut_size;
-            }
+        if (!reaped) {
+            pthread_mutex_unlock(&aptr->lock);
+            return (*status = READ_ERROR);
         }
     }
+#endif
 
-    memcpy(memory_io->data + offset, data, size);
+    while (block && !aptr->completion_count && aptr->in_flight) {
+        pthread_cond_wait(&aptr->completed, &aptr->lock);
+    }
 
-    return size;
+    size_t collected = aptr->completion_count < max ? aptr->completion_count : max;
+    for (size_t i = 0; i < collected; i++) {
+        completions[i] = aptr->completions[aptr->completion_head];
+        aptr->completion_head = (aptr->completion_head + 1) % aptr->depth;
+    }
+    aptr->completion_count -= collected;
+    aptr->in_flight -= collected;
+
+    pthread_mutex_unlock(&aptr->lock);
+
+    *count = collected;
+    return (*status);
 }
 
-static size_t ser_file_read(void* io_context, void* buffer, size_t size, size_t offset) {
-    FILE* file_io = (FILE*)io_context;
-    fseek(file_io, offset, SEEK_SET);
-    return fread(buffer, 1, size, file_io);
+int ser_async_poll(serasync* aptr, sercompletion* completions, size_t max, size_t* count, int* status) {
+    return ser_async_collect(aptr, completions, max, count, false, status);
 }
 
-static size_t ser_file_write(void* io_context, const void* data, size_t size, size_t offset) {
-    FILE* file_io = (FILE*)io_context;
-    fseek(file_io, offset, SEEK_SET);
-    return fwrite(data, 1, size, file_io);
+int ser_async_wait(serasync* aptr, sercompletion* completions, size_t max, size_t* count, int* status) {
+    return ser_async_collect(aptr, completions, max, count, true, status);
 }
 
-static void ser_header_initializations(serfile* sptr) {
-    memset(sptr->file_id,           0, FILEID_LEN);
-    sptr->lu_id =                   0;
-    sptr->color_id =                MONO;
-    sptr->little_endian =           LITTLEENDIAN_TRUE;
-    sptr->image_width =             0;
-    sptr->image_height =            0;
-    sptr->pixel_depth_per_plane =   8;
-    sptr->frame_count =             0;
-    memset(sptr->observer,          0, OBSERVER_LEN);
-    memset(sptr->instrument,        0, INSTRUMENT_LEN);
-    memset(sptr->telescope,         0, TELESCOPE_LEN);
-    sptr->date_time =               0;
-    sptr->date_time_utc =           0;
-    sptr->writer(sptr->io_context, sptr->file_id, FILEID_LEN, FILEID_KEY);
-    sptr->writer(sptr->io_context, &sptr->lu_id, LUID_LEN, LUID_KEY);
-    sptr->writer(sptr->io_context, &sptr->color_id, COLORID_LEN, COLORID_KEY);
-    sptr->writer(sptr->io_context, &sptr->little_endian, LITTLEENDIAN_LEN, LITTLEENDIAN_KEY);
-    sptr->writer(sptr->io_context, &sptr->image_width, IMAGEWIDTH_LEN, IMAGEWIDTH_KEY);
-    sptr->writer(sptr->io_context, &sptr->image_height, IMAGEHEIGHT_LEN, IMAGEHEIGHT_KEY);
-    sptr->writer(sptr->io_context, &sptr->pixel_depth_per_plane, PIXELDEPTHPERPLANE_LEN, PIXELDEPTHPERPLANE_KEY);
-    sptr->writer(sptr->io_context, &sptr->frame_count, FRAMECOUNT_LEN, FRAMECOUNT_KEY);
-    sptr->writer(sptr->io_context, sptr->observer, OBSERVER_LEN, OBSERVER_KEY);
-    sptr->writer(sptr->io_context, sptr->instrument, INSTRUMENT_LEN, INSTRUMENT_KEY);
-    sptr->writer(sptr->io_context, sptr->telescope, TELESCOPE_LEN, TELESCOPE_KEY);
-    sptr->writer(sptr->io_context, &sptr->date_time, DATETIME_LEN, DATETIME_KEY);
-    sptr->writer(sptr->io_context, &sptr->date_time_utc, DATETIMEUTC_LEN, DATETIMEUTC_KEY);
+int ser_async_destroy(serasync* aptr, int* status) {
+    RETURN_IF_NULL_PARAM(aptr, status);
+
+#if defined(CSERIO_IO_URING)
+    /* the kernel may still be writing into the destination buffers */
+    if (aptr->ring) {
+        pthread_mutex_lock(&aptr->lock);
+        while (aptr->in_flight > aptr->completion_count && ser_ring_reap(aptr, true)) {
+            continue;
+        }
+        pthread_mutex_unlock(&aptr->lock);
+        ser_ring_destroy(aptr->ring);
+    }
+#endif
+
+    pthread_mutex_lock(&aptr->lock);
+    aptr->stopping = true;
+    pthread_cond_broadcast(&aptr->queued);
+    pthread_mutex_unlock(&aptr->lock);
+
+    for (size_t i = 0; i < aptr->worker_count; i++) {
+        pthread_join(aptr->workers[i], NULL);
+    }
+
+    pthread_cond_destroy(&aptr->completed);
+    pthread_cond_destroy(&aptr->queued);
+    pthread_mutex_destroy(&aptr->lock);
+    ser_async_free(aptr);
+
+    return (*status);
 }
 
+#else
 
-/*-------------------- Core Routines --------------------*/
+int ser_async_create(serasync** aptr, serfile* sptr, size_t depth, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    (void)aptr; (void)sptr; (void)depth;
+    return (*status = NOT_SUPPORTED);
+}
 
-void cserio_version_number(int* major, int* minor, int* micro) {
-    if (major) {
-        *major = CSERIO_MAJOR;
+int ser_async_submit(serasync* aptr, void* dest, size_t idx, void* user_data, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    (void)aptr; (void)dest; (void)idx; (void)user_data;
+    return (*status = NOT_SUPPORTED);
+}
+
+int ser_async_poll(serasync* aptr, sercompletion* completions, size_t max, size_t* count, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    (void)aptr; (void)completions; (void)max; (void)count;
+    return (*status = NOT_SUPPORTED);
+}
+
+int ser_async_wait(serasync* aptr, sercompletion* completions, size_t max, size_t* count, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    (void)aptr; (void)completions; (void)max; (void)count;
+    return (*status = NOT_SUPPORTED);
+}
+
+int ser_async_destroy(serasync* aptr, int* status) {
+    (void)aptr;
+    return (*status = NOT_SUPPORTED);
+}
+
+#endif
+
+/*-------------------- Parallel Read Routines --------------------*/
+
+#if defined(CSERIO_POSIX)
+
+/* 
+ *  Upper bound on the threads of ser_read_frames_parallel, and the
+ *  default byte size of the chunk a thread claims at a time.
+ */
+#define SER_PARALLEL_MAX_THREADS            64
+#define SER_PARALLEL_CHUNK_SIZE             ((size_t)4 << 20)
+
+/*  Resolves a requested thread count, 0 meaning one per online CPU,
+ *  and bounds it by the units of work and SER_PARALLEL_MAX_THREADS.
+ */
+static size_t ser_parallel_threads(size_t nthreads, size_t units) {
+    if (nthreads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        nthreads = online > 0 ? (size_t)online : 1;
     }
-    if (minor) {
-        *minor = CSERIO_MINOR;
+    if (nthreads > units) {
+        nthreads = units;
     }
-    if (micro) {
-        *micro = CSERIO_MICRO;
+    if (nthreads > SER_PARALLEL_MAX_THREADS) {
+        nthreads = SER_PARALLEL_MAX_THREADS;
     }
-    return;
+    return nthreads ? nthreads : 1;
 }
 
+typedef struct {
+    serfile*        sptr;
+    uint8_t*        dest;
+    int             fd;
+    uint64_t        offset;
+    size_t          frame_byte_size;
+    size_t          count;
+    size_t          chunk;
+    size_t          next;
+    bool            failed;
+    pthread_mutex_t lock;
+} serParallel;
+
+/*  Claims chunks of the range until none are left. Reads with pread
+ *  when the job has a descriptor, otherwise copies from the lender.
+ */
+static void* ser_parallel_worker(void* arg) {
+    serParallel* job = (serParallel*)arg;
 
-/*-------------------- SER Access Routines --------------------*/
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        if (job->failed || job->next >= job->count) {
+            pthread_mutex_unlock(&job->lock);
+            break;
+        }
+        size_t idx = job->next;
+        size_t frames = job->count - idx < job->chunk ? job->count - idx : job->chunk;
+        job->next += frames;
+        pthread_mutex_unlock(&job->lock);
+
+        size_t size = frames * job->frame_byte_size;
+        uint64_t offset = job->offset + (uint64_t)idx * job->frame_byte_size;
+        uint8_t* dest = job->dest + idx * job->frame_byte_size;
+
+        bool done = false;
+        if (job->fd >= 0) {
+            done = ser_fd_read(&job->fd, dest, size, offset) == size;
+        } else {
+            const void* src = job->sptr->lender(job->sptr->io_context, size, offset);
+            if (src) {
+                memcpy(dest, src, size);
+                done = true;
+            }
+        }
 
-int ser_create_file(serfile** sptr, const char* path, int* status) {
+        if (!done) {
+            pthread_mutex_lock(&job->lock);
+            job->failed = true;
+            pthread_mutex_unlock(&job->lock);
+        }
+    }
+
+    return NULL;
+}
+
+int ser_read_frames_parallel(serfile* sptr, void* dest, size_t first, size_t count, size_t nthreads, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTRPTR(sptr, status);
-	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_DEST_BUFF(dest, status);
 
-    if (!path) {
-        return (*status = NULL_PATH);
+    uint64_t range_offset = 0;
+    size_t range_byte_size = 0;
+    if (ser_frame_span(sptr, first, count, &range_offset, &range_byte_size, status)) {
+        return (*status);
+    }
+    if (count == 0) {
+        return (*status);
     }
 
-    FILE* file;
-    if ((file = fopen(path, "r"))) {
-        fclose(file);
-        return (*status = FILE_EXISTS);
+    /* staged and custom backends are only safe from one thread */
+    int fd = -1;
+    if (!sptr->lender) {
+        if (sptr->reader != ser_file_read && sptr->reader != ser_fd_read) {
+            return ser_read_frames(sptr, dest, first, count, status);
+        }
+        if (sptr->reader == ser_file_read && fflush((FILE*)sptr->io_context)) {
+            return (*status = READ_ERROR);
+        }
+        fd = ser_backend_fd(sptr);
     }
 
-    file = fopen(path, "w+b");
-    if (!file) {
-        return (*status = FILE_OPEN_ERROR);
+    serParallel job;
+    job.sptr = sptr;
+    job.dest = (uint8_t*)dest;
+    job.fd = fd;
+    job.offset = range_offset;
+    job.frame_byte_size = range_byte_size / count;
+    job.count = count;
+    job.chunk = sptr->parallel_chunk;
+    job.next = 0;
+    job.failed = false;
+
+    if (job.chunk == 0) {
+        job.chunk = job.frame_byte_size ? SER_PARALLEL_CHUNK_SIZE / job.frame_byte_size : count;
+        job.chunk = job.chunk ? job.chunk : 1;
     }
 
-    *sptr = (serfile*)malloc(sizeof(serfile));
-    if (!*sptr) {
-        fclose(file);
-        return (*status = MEM_ALLOC);
+    size_t chunks = count / job.chunk + (count % job.chunk ? 1 : 0);
+    nthreads = ser_parallel_threads(nthreads, chunks);
+
+    /* the caller is one of the threads, failed spawns just mean fewer */
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_t threads[SER_PARALLEL_MAX_THREADS];
+    size_t spawned = 0;
+    while (spawned + 1 < nthreads) {
+        if (pthread_create(&threads[spawned], NULL, ser_parallel_worker, &job)) {
+            break;
+        }
+        spawned++;
     }
 
-    (*sptr)->io_context = file;
-    (*sptr)->reader = ser_file_read;
-    (*sptr)->writer = ser_file_write;
-    (*sptr)->access_mode = READWRITE;
+    ser_parallel_worker(&job);
+    for (size_t i = 0; i < spawned; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_mutex_destroy(&job.lock);
 
-    ser_header_initializations(*sptr);
+    if (job.failed) {
+        return (*status = READ_ERROR);
+    }
 
-    (*sptr)->has_trailer = (*sptr)->date_time <= 0 ? false : true;
-    (*sptr)->timestamps = NULL;
-    (*sptr)->timestamp_count = 0;
+    ser_release_span(sptr, range_offset, range_byte_size);
+    if (sptr->prefetch) {
+        ser_prefetch_advance(sptr, first + count);
+    }
 
     return (*status);
 }
 
-int ser_open_file(serfile** sptr, const char* path, int mode, int* status) {
+#else
+
+int ser_read_frames_parallel(serfile* sptr, void* dest, size_t first, size_t count, size_t nthreads, int* status) {
+    (void)nthreads;
+    return ser_read_frames(sptr, dest, first, count, status);
+}
+
+#endif
+
+int ser_set_parallel_chunk(serfile* sptr, size_t frames, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTRPTR(sptr, status);
-	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+	RETURN_IF_NULL_SPTR(sptr, status);
 
-    if (!path) {
-        return (*status = NULL_PATH);
+    sptr->parallel_chunk = frames;
+
+    return (*status);
+}
+
+/*-------------------- Frame Driver Routines --------------------*/
+
+/*  Walks the range on the calling thread through ser_read_frame. */
+static int ser_for_each_serial(serfile* sptr, size_t first, size_t count, serframefn callback, void* user, serframefn complete, int* status) {
+    unsigned long frame_byte_size = 0;
+    ser_get_frame_byte_size(sptr, &frame_byte_size, status);
+    if (*status) {
+        return (*status);
     }
 
-    FILE* file;
-    switch (mode) {
-        case READWRITE:
-            file = fopen(path, "r+b");
-            break;
-        case READONLY:
-        default:
-            file = fopen(path, "rb");
+    void* buffer = malloc(frame_byte_size ? frame_byte_size : 1);
+    if (!buffer) {
+        return (*status = MEM_ALLOC);
     }
-    
-    if (!file) {
-        return (*status = FILE_DNE);
+
+    for (size_t idx = first; idx < first + count; idx++) {
+        if (ser_read_frame(sptr, buffer, idx, status)) {
+            break;
+        }
+        if (callback(idx, buffer, user) || (complete && complete(idx, buffer, user))) {
+            *status = CALLBACK_ABORTED;
+            break;
+        }
     }
 
-    /* retrieve size of file and return to start */
-    fseek(file, 0, SEEK_END);
-    size_t file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
+    free(buffer);
+    return (*status);
+}
+
+#if defined(CSERIO_POSIX)
 
-    /* determine validity of header */
-    if (file_size < HDR_SIZE) {
-        fclose(file);
-        return (*status = INVALID_STRUCTURE);
+/* 
+ *  Frames [next, end) of the range still owned by one thread. The 
+ *  owner takes from the front, thieves take from the back.
+ */
+typedef struct {
+    pthread_mutex_t lock;
+    size_t          next;
+    size_t          end;
+} serForEachQueue;
+
+typedef struct {
+    serfile*        sptr;
+    int             fd;
+    uint64_t        offset;
+    size_t          first;
+    size_t          frame_byte_size;
+    serframefn      callback;
+    serframefn      complete;
+    void*           user;
+    bool            ordered;
+
+    size_t          nqueues;
+    serForEachQueue queues[SER_PARALLEL_MAX_THREADS];
+
+    pthread_mutex_t lock;
+    pthread_cond_t  turn;
+    size_t          completed;
+    int             error;
+} serForEach;
+
+typedef struct {
+    serForEach*     job;
+    size_t          self;
+} serForEachWorker;
+
+/*  Takes the next frame of the thread's own queue, or steals the 
+ *  back half of the fullest queue once its own is empty. Returns 
+ *  false when no frames are left anywhere.
+ */
+static bool ser_for_each_claim(serForEach* job, size_t self, size_t* idx) {
+    serForEachQueue* own = &job->queues[self];
+
+    pthread_mutex_lock(&own->lock);
+    bool claimed = own->next < own->end;
+    if (claimed) {
+        *idx = own->next++;
     }
+    pthread_mutex_unlock(&own->lock);
+
+    while (!claimed) {
+        size_t victim = self;
+        size_t most = 0;
+        for (size_t i = 0; i < job->nqueues; i++) {
+            pthread_mutex_lock(&job->queues[i].lock);
+            size_t left = job->queues[i].end - job->queues[i].next;
+            pthread_mutex_unlock(&job->queues[i].lock);
+            if (left > most) {
+                most = left;
+                victim = i;
+            }
+        }
+        if (most == 0) {
+            return false;
+        }
 
-    /* allocate memory for serfile */
-    *sptr = (serfile*)malloc(sizeof(serfile));
-    if (!*sptr) {
-        fclose(file);
-        return (*status = MEM_ALLOC);
+        /* the victim may have drained since, look again if so */
+        serForEachQueue* from = &job->queues[victim];
+        pthread_mutex_lock(&from->lock);
+        size_t left = from->end - from->next;
+        size_t start = from->end - (left + 1) / 2;
+        size_t end = from->end;
+        from->end = start;
+        pthread_mutex_unlock(&from->lock);
+
+        if (start < end) {
+            pthread_mutex_lock(&own->lock);
+            own->next = start + 1;
+            own->end = end;
+            pthread_mutex_unlock(&own->lock);
+            *idx = start;
+            claimed = true;
+        }
     }
 
-    /* general setup */
-    (*sptr)->io_context = file;
-    (*sptr)->reader = ser_file_read;
-    (*sptr)->writer = ser_file_write;
-    (*sptr)->access_mode = mode == READWRITE ? READWRITE : READONLY;
-    (*sptr)->reader(file, (*sptr)->file_id, FILEID_LEN, FILEID_KEY);
-    (*sptr)->reader(file, &(*sptr)->lu_id, LUID_LEN, LUID_KEY);
-    (*sptr)->reader(file, &(*sptr)->color_id, COLORID_LEN, COLORID_KEY);
-    (*sptr)->reader(file, &(*sptr)->little_endian, LITTLEENDIAN_LEN, LITTLEENDIAN_KEY);
-    (*sptr)->reader(file, &(*sptr)->image_width, IMAGEWIDTH_LEN, IMAGEWIDTH_KEY);
-    (*sptr)->reader(file, &(*sptr)->image_height, IMAGEHEIGHT_LEN, IMAGEHEIGHT_KEY);
-    (*sptr)->reader(file, &(*sptr)->pixel_depth_per_plane, PIXELDEPTHPERPLANE_LEN, PIXELDEPTHPERPLANE_KEY);
-    (*sptr)->reader(file, &(*sptr)->frame_count, FRAMECOUNT_LEN, FRAMECOUNT_KEY);
-    (*sptr)->reader(file, (*sptr)->observer, OBSERVER_LEN, OBSERVER_KEY);
-    (*sptr)->reader(file, (*sptr)->instrument, INSTRUMENT_LEN, INSTRUMENT_KEY);
-    (*sptr)->reader(file, (*sptr)->telescope, TELESCOPE_LEN, TELESCOPE_KEY);
-    (*sptr)->reader(file, &(*sptr)->date_time, DATETIME_LEN, DATETIME_KEY);
-    (*sptr)->reader(file, &(*sptr)->date_time_utc, DATETIMEUTC_LEN, DATETIMEUTC_KEY);
-    (*sptr)->has_trailer = (*sptr)->date_time <= 0 ? false : true;
-    (*sptr)->timestamps = NULL;
-    (*sptr)->timestamp_count = 0;
+    return true;
+}
 
-    /* determine if valid hdr + data or hdr + data + trailer */
-    size_t frame_byte_size = 0;
-    ser_get_frame_byte_size(*sptr, &frame_byte_size, status);
-    size_t trailer_offset = HDR_SIZE + (*sptr)->frame_count * frame_byte_size;
+static void* ser_for_each_worker(void* arg) {
+    serForEachWorker* worker = (serForEachWorker*)arg;
+    serForEach* job = worker->job;
+
+    uint8_t* buffer = NULL;
+    if (job->fd >= 0) {
+        buffer = (uint8_t*)malloc(job->frame_byte_size ? job->frame_byte_size : 1);
+        if (!buffer) {
+            pthread_mutex_lock(&job->lock);
+            job->error = job->error ? job->error : MEM_ALLOC;
+            pthread_cond_broadcast(&job->turn);
+            pthread_mutex_unlock(&job->lock);
+            return NULL;
+        }
+    }
 
-    if ((*sptr)->has_trailer) {
-        if (file_size == trailer_offset + (*sptr)->frame_count * sizeof(uint64_t)) {
-            (*sptr)->timestamps = (int64_t*)realloc((*sptr)->timestamps, (*sptr)->frame_count * sizeof(uint64_t));
-            (*sptr)->timestamp_count = (*sptr)->frame_count;
-            (*sptr)->reader(
-                    (*sptr)->io_context,
-                    (*sptr)->timestamps,
-                    (*sptr)->frame_count * sizeof(uint64_t),
-                    trailer_offset
-            );
-            return (*status);
+    pthread_mutex_lock(&job->lock);
+    pthread_mutex_unlock(&job->lock);
+
+    size_t idx = 0;
+    bool stop = false;
+    while (!stop && ser_for_each_claim(job, worker->self, &idx)) {
+        uint64_t offset = job->offset + (uint64_t)idx * job->frame_byte_size;
+        const void* frame = buffer;
+        int error = NO_ERROR;
+        if (job->fd >= 0) {
+            if (ser_fd_read(&job->fd, buffer, job->frame_byte_size, offset) != job->frame_byte_size) {
+                error = READ_ERROR;
+            }
+        } else {
+            frame = job->sptr->lender(job->sptr->io_context, job->frame_byte_size, offset);
+            if (!frame) {
+                error = READ_ERROR;
+            }
         }
-    } else {
-        if (file_size == trailer_offset) {
-            return (*status);
+        if (!error && job->callback(job->first + idx, frame, job->user)) {
+            error = CALLBACK_ABORTED;
+        }
+
+        /* a thread waiting its turn holds the lowest frame of its queue, so turns always come */
+        pthread_mutex_lock(&job->lock);
+        while (job->ordered && !error && !job->error && job->completed != idx) {
+            pthread_cond_wait(&job->turn, &job->lock);
+        }
+        if (!error && !job->error && job->complete && job->complete(job->first + idx, frame, job->user)) {
+            error = CALLBACK_ABORTED;
+        }
+        if (error && !job->error) {
+            job->error = error;
+        }
+        job->completed++;
+        stop = job->error != NO_ERROR;
+        if (job->ordered || stop) {
+            pthread_cond_broadcast(&job->turn);
         }
+        pthread_mutex_unlock(&job->lock);
     }
 
-    /* if reached, invalid structure */
-    fclose(file);
-    free((*sptr));
-    *sptr = NULL;
-    return (*status = INVALID_STRUCTURE);
+    free(buffer);
+    return NULL;
 }
 
-int ser_close_file(serfile* sptr, int* status) {
+int ser_for_each_frame(serfile* sptr, size_t first, size_t count, serframefn callback, void* user, const serforeachopts* opts, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
 	RETURN_IF_NULL_SPTR(sptr, status);
+    RETURN_IF_NULL_PARAM(callback, status);
 
-    if (sptr->timestamps && sptr->access_mode == READWRITE) {
-        size_t image_frame_byte_size = 0;
-        ser_get_frame_byte_size(sptr, &image_frame_byte_size, status);
-        size_t image_data_size = sptr->frame_count * image_frame_byte_size;
+    uint64_t range_offset = 0;
+    size_t range_byte_size = 0;
+    if (ser_frame_span(sptr, first, count, &range_offset, &range_byte_size, status)) {
+        return (*status);
+    }
+    if (count == 0) {
+        return (*status);
+    }
 
-        size_t trailer_offset = HDR_SIZE + image_data_size;
-        size_t trailer_size = sizeof(int64_t) * sptr->timestamp_count;
+    serforeachopts defaults = {0, false, NULL};
+    opts = opts ? opts : &defaults;
 
-        size_t bytes_written = sptr->writer(
-                sptr->io_context,
-                sptr->timestamps,
-                trailer_size,
-                trailer_offset
-        );
-        if (bytes_written != trailer_size) {
-            *status = TRAILER_CLOSE_WARN;
+    /* staged and custom backends are only safe from one thread */
+    int fd = -1;
+    if (!sptr->lender) {
+        if (sptr->reader != ser_file_read && sptr->reader != ser_fd_read) {
+            return ser_for_each_serial(sptr, first, count, callback, user, opts->complete, status);
+        }
+        if (sptr->reader == ser_file_read && fflush((FILE*)sptr->io_context)) {
+            return (*status = READ_ERROR);
         }
-        free(sptr->timestamps);
+        fd = ser_backend_fd(sptr);
     }
 
-    if (!sptr->io_context || fclose((FILE*)sptr->io_context)) {
-        *status = FILE_CLOSE_ERROR;
+    size_t nthreads = ser_parallel_threads(opts->nthreads, count);
+
+    serForEach job;
+    job.sptr = sptr;
+    job.fd = fd;
+    job.offset = range_offset;
+    job.first = first;
+    job.frame_byte_size = range_byte_size / count;
+    job.callback = callback;
+    job.complete = opts->complete;
+    job.user = user;
+    job.ordered = opts->ordered;
+    job.nqueues = 0;
+    job.completed = 0;
+    job.error = NO_ERROR;
+
+    pthread_mutex_init(&job.lock, NULL);
+    pthread_cond_init(&job.turn, NULL);
+    serForEachWorker workers[SER_PARALLEL_MAX_THREADS];
+    for (size_t i = 0; i < nthreads; i++) {
+        workers[i].job = &job;
+        workers[i].self = i;
     }
 
-    free(sptr);
-    sptr = NULL;
-    return (*status);
-}
+    /* 
+     *  Workers wait on the lock until the range is split between 
+     *  the threads that actually started. The caller is worker 0.
+     */
+    pthread_t threads[SER_PARALLEL_MAX_THREADS];
+    pthread_mutex_lock(&job.lock);
+    size_t spawned = 1;
+    while (spawned < nthreads) {
+        if (pthread_create(&threads[spawned], NULL, ser_for_each_worker, &workers[spawned])) {
+            break;
+        }
+        spawned++;
+    }
+    job.nqueues = spawned;
+    for (size_t i = 0; i < spawned; i++) {
+        pthread_mutex_init(&job.queues[i].lock, NULL);
+        job.queues[i].next = count * i / spawned;
+        job.queues[i].end = count * (i + 1) / spawned;
+    }
+    pthread_mutex_unlock(&job.lock);
 
-/*-------------------- Header Routines --------------------*/
+    ser_for_each_worker(&workers[0]);
+    for (size_t i = 1; i < spawned; i++) {
+        pthread_join(threads[i], NULL);
+    }
 
-int ser_read_rec_count(serfile* sptr, int* rec_count, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_PARAM(rec_count, status);
-    *rec_count = HDR_UNIT_COUNT;
-    return (*status);
-}
+    for (size_t i = 0; i < spawned; i++) {
+        pthread_mutex_destroy(&job.queues[i].lock);
+    }
+    pthread_cond_destroy(&job.turn);
+    pthread_mutex_destroy(&job.lock);
 
-int ser_read_file_id(serfile* sptr, char* file_id, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(file_id, status);
-    sptr->reader(sptr->io_context, sptr->file_id, FILEID_LEN, FILEID_KEY);
-    memcpy(file_id, sptr->file_id, FILEID_LEN);
-    return (*status);
-}
+    if (job.error) {
+        return (*status = job.error);
+    }
 
-int ser_read_lu_id(serfile* sptr, int32_t* lu_id, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(lu_id, status);
-    sptr->reader(sptr->io_context, &sptr->lu_id, LUID_LEN, LUID_KEY); 
-    *lu_id = sptr->lu_id;
-    return (*status);
-}
+    ser_release_span(sptr, range_offset, range_byte_size);
 
-int ser_read_color_id(serfile* sptr, int32_t* color_id, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(color_id, status);
-    sptr->reader(sptr->io_context, &sptr->color_id, COLORID_LEN, COLORID_KEY); 
-    *color_id = sptr->color_id;
     return (*status);
 }
 
-int ser_read_little_endian(serfile* sptr, int32_t* little_endian, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(little_endian, status);
-    sptr->reader(sptr->io_context, &sptr->little_endian, LITTLEENDIAN_LEN, LITTLEENDIAN_KEY); 
-    *little_endian = sptr->little_endian;
-    return (*status);
-}
+#else
 
-int ser_read_image_width(serfile* sptr, int32_t* image_width, int* status) {
+int ser_for_each_frame(serfile* sptr, size_t first, size_t count, serframefn callback, void* user, const serforeachopts* opts, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
 	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(image_width, status);
-    sptr->reader(sptr->io_context, &sptr->image_width, IMAGEWIDTH_LEN, IMAGEWIDTH_KEY); 
-    *image_width = sptr->image_width;
-    return (*status);
-}
+    RETURN_IF_NULL_PARAM(callback, status);
 
-int ser_read_image_height(serfile* sptr, int32_t* image_height, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(image_height, status);
-    sptr->reader(sptr->io_context, &sptr->image_height, IMAGEHEIGHT_LEN, IMAGEHEIGHT_KEY); 
-    *image_height = sptr->image_height;
-    return (*status);
-}
+    uint64_t range_offset = 0;
+    size_t range_byte_size = 0;
+    if (ser_frame_span(sptr, first, count, &range_offset, &range_byte_size, status)) {
+        return (*status);
+    }
 
-int ser_read_pixel_depth_per_plane(serfile* sptr, int32_t* pixel_depth_per_plane, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(pixel_depth_per_plane, status);
-    sptr->reader(sptr->io_context, &sptr->pixel_depth_per_plane, PIXELDEPTHPERPLANE_LEN, PIXELDEPTHPERPLANE_KEY); 
-    *pixel_depth_per_plane = sptr->pixel_depth_per_plane;
-    return (*status);
+    return ser_for_each_serial(sptr, first, count, callback, user, opts ? opts->complete : NULL, status);
 }
 
-int ser_read_frame_count(serfile* sptr, int32_t* frame_count, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(frame_count, status);
-    sptr->reader(sptr->io_context, &sptr->frame_count, FRAMECOUNT_LEN, FRAMECOUNT_KEY); 
-    *frame_count = sptr->frame_count;
-    return (*status);
-}
+#endif
 
-int ser_read_observer(serfile* sptr, char* observer, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(observer, status);
-    sptr->reader(sptr->io_context, sptr->observer, OBSERVER_LEN, OBSERVER_KEY); 
-    memcpy(observer, sptr->observer, OBSERVER_LEN);
-    return (*status);
-}
+/*-------------------- Capture Queue Routines --------------------*/
 
-int ser_read_instrument(serfile* sptr, char* instrument, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(instrument, status);
-    sptr->reader(sptr->io_context, sptr->instrument, INSTRUMENT_LEN, INSTRUMENT_KEY); 
-    memcpy(instrument, sptr->instrument, INSTRUMENT_LEN);
-    return (*status);
-}
+#if defined(CSERIO_POSIX) && defined(__GNUC__)
 
-int ser_read_telescope(serfile* sptr, char* telescope, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(telescope, status);
-    sptr->reader(sptr->io_context, sptr->telescope, TELESCOPE_LEN, TELESCOPE_KEY); 
-    memcpy(telescope, sptr->telescope, TELESCOPE_LEN);
-    return (*status);
-}
+/* 
+ *  The ring indices are only ever advanced by one side each, so 
+ *  acquire/release ordering on them is all the synchronization the
+ *  slots need.
+ */
+#define SER_ATOMIC_LOAD(ptr)                __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define SER_ATOMIC_STORE(ptr, value)        __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
 
-int ser_read_date_time(serfile* sptr, int64_t* date_time, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(date_time, status);
-    sptr->reader(sptr->io_context, &sptr->date_time, DATETIME_LEN, DATETIME_KEY); 
-    *date_time = sptr->date_time;
-    return (*status);
-}
+/* 
+ *  Time the writer sleeps when it finds the ring empty.
+ */
+#define SER_CAPTURE_IDLE_NS                 200000
+
+struct sercapture {
+    serfile*    sptr;
+    uint8_t*    frames;
+    uint64_t*   timestamps;
+    size_t      slots;
+    size_t      frame_byte_size;
+
+    size_t      head;
+    size_t      tail;
+    size_t      high_water;
+    size_t      written;
+    size_t      dropped;
+    size_t      failed;
+    int         error;
+    bool        stopping;
+
+    pthread_t   writer;
+};
+
+static void* ser_capture_writer(void* arg) {
+    sercapture* capture = (sercapture*)arg;
+    struct timespec idle = {0, SER_CAPTURE_IDLE_NS};
+
+    for (;;) {
+        size_t tail = capture->tail;
+        size_t head = SER_ATOMIC_LOAD(&capture->head);
+        if (tail == head) {
+            if (SER_ATOMIC_LOAD(&capture->stopping) && head == SER_ATOMIC_LOAD(&capture->head)) {
+                break;
+            }
+            nanosleep(&idle, NULL);
+            continue;
+        }
 
-int ser_read_date_time_utc(serfile* sptr, int64_t* date_time_utc, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(date_time_utc, status);
-    sptr->reader(sptr->io_context, &sptr->date_time_utc, DATETIMEUTC_LEN, DATETIMEUTC_KEY); 
-    *date_time_utc = sptr->date_time_utc;
-    return (*status);
-}
+        for (; tail != head; tail++) {
+            size_t slot = tail % capture->slots;
+            if (!capture->error) {
+                int status = 0;
+                ser_append_frame(
+                        capture->sptr,
+                        capture->frames + slot * capture->frame_byte_size,
+                        capture->timestamps[slot],
+                        &status
+                );
+                SER_ATOMIC_STORE(&capture->error, status);
+            }
+            if (capture->error) {
+                SER_ATOMIC_STORE(&capture->failed, capture->failed + 1);
+            } else {
+                SER_ATOMIC_STORE(&capture->written, capture->written + 1);
+            }
+            SER_ATOMIC_STORE(&capture->tail, tail + 1);
+        }
+    }
 
-int ser_write_file_id(serfile* sptr, const char* file_id, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_PARAM(file_id, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
-    memcpy(sptr->file_id, file_id, FILEID_LEN);
-    sptr->writer(sptr->io_context, sptr->file_id, FILEID_LEN, FILEID_KEY);
-    return (*status);
+    return NULL;
 }
 
-int ser_write_lu_id(serfile* sptr, const int32_t lu_id, int* status) {
+int ser_capture_create(sercapture** cptr, serfile* sptr, size_t slots, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
+    RETURN_IF_NULL_PARAM(cptr, status);
 	RETURN_IF_NULL_SPTR(sptr, status);
 	RETURN_IF_WRITE_ON_READONLY(sptr, status);
-    sptr->lu_id = lu_id;
-    sptr->writer(sptr->io_context, &sptr->lu_id, LUID_LEN, LUID_KEY);
-    return (*status);
-}
 
-int ser_write_color_id(serfile* sptr, const int32_t color_id, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    if (slots == 0) {
+        return (*status = INVALID_ASYNC_DEPTH);
+    }
 
-    /* valid color id value */
-    switch (color_id) {
-		case MONO:
-		case BAYER_RGGB:
-		case BAYER_GRBG:
-		case BAYER_GBRG:
-		case BAYER_BGGR:
-		case BAYER_CYYM:
-		case BAYER_YCMY:
-		case BAYER_YMCY:
-		case BAYER_MYYC:
-		case RGB:
-		case BGR:
-            break;
-        default:
-            return (*status = INVALID_SET_VALUE);
+    unsigned long frame_byte_size = 0;
+    ser_get_frame_byte_size(sptr, &frame_byte_size, status);
+    if (*status) {
+        return (*status);
+    }
+    if (frame_byte_size == 0) {
+        return (*status = INVALID_FRAME_SIZE);
+    }
+    if (slots > SIZE_MAX / frame_byte_size) {
+        return (*status = SIZE_OVERFLOW);
     }
 
-    /* check for switch between 1 byte and 3 byte color ids */
-    if (sptr->frame_count > 0) {
-        if (sptr->color_id < 100 && color_id >= 100) {
-            return (*status = INVALID_SET_STATE);
-        }
-        if (sptr->color_id >= 100 && color_id < 100) {
-            return (*status = INVALID_SET_STATE);
-        }
+    sercapture* capture = (sercapture*)calloc(1, sizeof(sercapture));
+    if (!capture) {
+        return (*status = MEM_ALLOC);
+    }
+    capture->sptr = sptr;
+    capture->slots = slots;
+    capture->frame_byte_size = frame_byte_size;
+    capture->frames = (uint8_t*)malloc(slots * frame_byte_size);
+    capture->timestamps = (uint64_t*)malloc(slots * sizeof(uint64_t));
+    if (!capture->frames || !capture->timestamps) {
+        free(capture->frames);
+        free(capture->timestamps);
+        free(capture);
+        return (*status = MEM_ALLOC);
     }
 
-    sptr->color_id = color_id;
-    sptr->writer(sptr->io_context, &sptr->color_id, COLORID_LEN, COLORID_KEY);
+    if (pthread_create(&capture->writer, NULL, ser_capture_writer, capture)) {
+        free(capture->frames);
+        free(capture->timestamps);
+        free(capture);
+        return (*status = ASYNC_INIT_ERROR);
+    }
 
+    *cptr = capture;
     return (*status);
 }
 
-int ser_write_little_endian(serfile* sptr, const int32_t little_endian, int* status) {
+int ser_capture_push(sercapture* cptr, const void* data, uint64_t timestamp, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    RETURN_IF_NULL_PARAM(cptr, status);
+    RETURN_IF_NULL_PARAM(data, status);
 
-    if (little_endian == LITTLEENDIAN_TRUE || little_endian == LITTLEENDIAN_FALSE) {
-        sptr->little_endian = little_endian;
-        sptr->writer(sptr->io_context, &sptr->little_endian, LITTLEENDIAN_LEN, LITTLEENDIAN_KEY);
-        return (*status);
+    size_t head = cptr->head;
+    size_t depth = head - SER_ATOMIC_LOAD(&cptr->tail);
+    if (depth == cptr->slots) {
+        SER_ATOMIC_STORE(&cptr->dropped, cptr->dropped + 1);
+        return (*status = ASYNC_QUEUE_FULL);
     }
 
-    return (*status = INVALID_SET_VALUE);
+    size_t slot = head % cptr->slots;
+    memcpy(cptr->frames + slot * cptr->frame_byte_size, data, cptr->frame_byte_size);
+    cptr->timestamps[slot] = timestamp;
+    SER_ATOMIC_STORE(&cptr->head, head + 1);
+
+    if (depth + 1 > cptr->high_water) {
+        SER_ATOMIC_STORE(&cptr->high_water, depth + 1);
+    }
+
+    return (*status);
 }
 
-int ser_write_image_width(serfile* sptr, const uint32_t image_width, int* status) {
+int ser_capture_stats(sercapture* cptr, sercapturestats* stats, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
-
-    if (sptr->frame_count > 0) {
-        return (*status = INVALID_SET_STATE);
-    }
+    RETURN_IF_NULL_PARAM(cptr, status);
+    RETURN_IF_NULL_PARAM(stats, status);
 
-    sptr->image_width = image_width;
-    sptr->writer(sptr->io_context, &sptr->image_width, IMAGEWIDTH_LEN, IMAGEWIDTH_KEY);
+    size_t tail = SER_ATOMIC_LOAD(&cptr->tail);
+    stats->depth = SER_ATOMIC_LOAD(&cptr->head) - tail;
+    stats->high_water = SER_ATOMIC_LOAD(&cptr->high_water);
+    stats->written = SER_ATOMIC_LOAD(&cptr->written);
+    stats->dropped = SER_ATOMIC_LOAD(&cptr->dropped) + SER_ATOMIC_LOAD(&cptr->failed);
 
     return (*status);
 }
 
-int ser_write_image_height(serfile* sptr, const uint32_t image_height, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+int ser_capture_destroy(sercapture* cptr, int* status) {
+    RETURN_IF_NULL_PARAM(cptr, status);
 
-    if (sptr->frame_count > 0) {
-        return (*status = INVALID_SET_STATE);
-    }
+    SER_ATOMIC_STORE(&cptr->stopping, true);
+    pthread_join(cptr->writer, NULL);
 
-    sptr->image_height = image_height;
-    sptr->writer(sptr->io_context, &sptr->image_height, IMAGEHEIGHT_LEN, IMAGEHEIGHT_KEY);
+    if (cptr->error) {
+        *status = cptr->error;
+    }
 
+    free(cptr->frames);
+    free(cptr->timestamps);
+    free(cptr);
     return (*status);
 }
 
-int ser_write_pixel_depth_per_plane(serfile* sptr, const int32_t pixel_depth_per_plane, int* status) {
+#else
+
+int ser_capture_create(sercapture** cptr, serfile* sptr, size_t slots, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    (void)cptr; (void)sptr; (void)slots;
+    return (*status = NOT_SUPPORTED);
+}
 
-    /* pdpp must between a value from 1 - 16 */
-    if (16 < pixel_depth_per_plane || pixel_depth_per_plane <= 0) {
-        return (*status = INVALID_SET_VALUE);
+int ser_capture_push(sercapture* cptr, const void* data, uint64_t timestamp, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    (void)cptr; (void)data; (void)timestamp;
+    return (*status = NOT_SUPPORTED);
+}
+
+int ser_capture_stats(sercapture* cptr, sercapturestats* stats, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+    (void)cptr; (void)stats;
+    return (*status = NOT_SUPPORTED);
+}
+
+int ser_capture_destroy(sercapture* cptr, int* status) {
+    (void)cptr;
+    return (*status = NOT_SUPPORTED);
+}
+
+#endif
+
+/*-------------------- Asynchronous Append Routines --------------------*/
+
+/* 
+ *  Default number of frames ser_append_frame_async keeps in flight.
+ */
+#define SER_APPEND_DEFAULT_DEPTH            4
+
+#if defined(CSERIO_POSIX)
+
+static int ser_appender_start(serfile* sptr, int* status) {
+    serAppender* appender = (serAppender*)calloc(1, sizeof(serAppender));
+    if (!appender) {
+        return (*status = MEM_ALLOC);
     }
 
-    /* if frames present, pdpp cannot switch between 1 and 2 bytes */
-    if (sptr->frame_count > 0) {
-        if (sptr->pixel_depth_per_plane <= 8 && pixel_depth_per_plane > 8) {
-            return (*status = INVALID_SET_STATE);
-        }
-        if (sptr->pixel_depth_per_plane > 8 && pixel_depth_per_plane <= 8) {
-            return (*status = INVALID_SET_STATE);
-        }
+    appender->sptr = sptr;
+    appender->depth = sptr->append_depth ? sptr->append_depth : SER_APPEND_DEFAULT_DEPTH;
+    appender->requests = (serAppendRequest*)calloc(appender->depth, sizeof(serAppendRequest));
+    if (!appender->requests) {
+        free(appender);
+        return (*status = MEM_ALLOC);
     }
 
-    sptr->pixel_depth_per_plane = pixel_depth_per_plane;
-    sptr->writer(sptr->io_context, &sptr->pixel_depth_per_plane, PIXELDEPTHPERPLANE_LEN, PIXELDEPTHPERPLANE_KEY);
+    pthread_mutex_init(&appender->lock, NULL);
+    pthread_cond_init(&appender->wake, NULL);
+    pthread_cond_init(&appender->idle, NULL);
+    if (pthread_create(&appender->thread, NULL, ser_appender_worker, appender)) {
+        pthread_cond_destroy(&appender->idle);
+        pthread_cond_destroy(&appender->wake);
+        pthread_mutex_destroy(&appender->lock);
+        free(appender->requests);
+        free(appender);
+        return (*status = ASYNC_INIT_ERROR);
+    }
 
+    sptr->appender = appender;
     return (*status);
 }
 
-int ser_write_observer(serfile* sptr, const char* observer, int* status) {
+int ser_append_frame_async(serfile* sptr, const void* data, uint64_t timestamp, serappendfn done, void* user, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
 	RETURN_IF_NULL_SPTR(sptr, status);
 	RETURN_IF_WRITE_ON_READONLY(sptr, status);
-    RETURN_IF_NULL_PARAM(observer, status);
-    memcpy(sptr->observer, observer, OBSERVER_LEN);
-    sptr->writer(sptr->io_context, sptr->observer, OBSERVER_LEN, OBSERVER_KEY);
-    return (*status);
-}
+    RETURN_IF_NULL_PARAM(data, status);
 
-int ser_write_instrument(serfile* sptr, const char* instrument, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
-    RETURN_IF_NULL_PARAM(instrument, status);
-    memcpy(sptr->instrument, instrument, INSTRUMENT_LEN);
-    sptr->writer(sptr->io_context, sptr->instrument, INSTRUMENT_LEN, INSTRUMENT_KEY);
-    return (*status);
-}
+    if (!sptr->appender && ser_appender_start(sptr, status)) {
+        return (*status);
+    }
+
+    serAppender* appender = sptr->appender;
+    pthread_mutex_lock(&appender->lock);
+    if (appender->count == appender->depth) {
+        pthread_mutex_unlock(&appender->lock);
+        return (*status = ASYNC_QUEUE_FULL);
+    }
+
+    serAppendRequest* request = &appender->requests[(appender->head + appender->count) % appender->depth];
+    request->data = data;
+    request->timestamp = timestamp;
+    request->done = done;
+    request->user = user;
+    appender->count += 1;
+    pthread_cond_signal(&appender->wake);
+    pthread_mutex_unlock(&appender->lock);
 
-int ser_write_telescope(serfile* sptr, const char* telescope, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
-    RETURN_IF_NULL_PARAM(telescope, status);
-    memcpy(sptr->telescope, telescope, TELESCOPE_LEN);
-    sptr->writer(sptr->io_context, sptr->telescope, TELESCOPE_LEN, TELESCOPE_KEY);
     return (*status);
 }
 
-int ser_write_date_time(serfile* sptr, const int64_t date_time, int* status) {
+#else
+
+int ser_append_frame_async(serfile* sptr, const void* data, uint64_t timestamp, serappendfn done, void* user, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
 	RETURN_IF_NULL_SPTR(sptr, status);
 	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    RETURN_IF_NULL_PARAM(data, status);
 
-    /* if frames are present and the new data_time would change trailer state, fail */
-    if (sptr->frame_count > 0) {
-        /* has trailer -> no trailer */
-        if (sptr->date_time > 0 && date_time <= 0) {
-            return (*status = INVALID_SET_STATE);
-        }
-        /* no trailer -> has trailer */
-        if (sptr->date_time <= 0 && date_time > 0) {
-            return (*status = INVALID_SET_STATE);
-        }
+    /* without threads the frame is appended before returning */
+    int error = ser_append_frame_now(sptr, data, timestamp);
+    if (done) {
+        done(data, user, error);
+        return (*status);
     }
 
-    sptr->date_time = date_time;
-    sptr->has_trailer = sptr->date_time <= 0 ? false : true;
-    sptr->writer(sptr->io_context, &sptr->date_time, DATETIME_LEN, DATETIME_KEY);
-
-    return (*status);
+    return (*status = error);
 }
 
-int ser_write_date_time_utc(serfile* sptr, const int64_t date_time_utc, int* status) {
+#endif
+
+int ser_set_append_depth(serfile* sptr, size_t depth, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
 	RETURN_IF_NULL_SPTR(sptr, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
-    sptr->date_time_utc = date_time_utc;
-    sptr->writer(sptr->io_context, &sptr->date_time_utc, DATETIMEUTC_LEN, DATETIMEUTC_KEY);
-    return (*status);
-}
 
+#if defined(CSERIO_POSIX)
+    if ((*status = ser_appender_stop(sptr))) {
+        return (*status);
+    }
+#endif
+    sptr->append_depth = depth;
 
-/*-------------------- Image Routines --------------------*/
-
-int ser_get_number_of_planes(serfile* sptr, int* nop, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_PARAM(nop, status);
-    *nop = sptr->color_id < 100 ? 1 : 3;
     return (*status);
 }
 
-int ser_get_bytes_per_pixel(serfile* sptr, unsigned long* bytes_per_pixel, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_PARAM(bytes_per_pixel, status);
+/*-------------------- Rollover Routines --------------------*/
 
-    int number_of_planes = sptr->color_id < 100 ? 1 : 3;
-    int pixel_depth = sptr->pixel_depth_per_plane;
+struct serrollover {
+    char*       stem;
+    serinfo     header;
+    uint64_t    max_bytes;
+    size_t      max_frames;
+    uint64_t    frame_byte_size;
 
-    if (pixel_depth <= 8) {
-        *bytes_per_pixel = number_of_planes; /* 1 byte per pixel */
+    serfile*    part;
+    size_t*     part_frames;
+    size_t      part_count;
+    size_t      part_capacity;
+};
+
+/*  Formats the path of part number part, or of the manifest when
+ *  part is 0. Returns NULL if allocation fails.
+ */
+static char* ser_rollover_path(const serrollover* rptr, size_t part) {
+    size_t size = strlen(rptr->stem) + 32;
+    char* path = (char*)malloc(size);
+    if (!path) {
+        return NULL;
+    }
+
+    if (part) {
+        snprintf(path, size, "%s.%04lu.ser", rptr->stem, (unsigned long)part);
     } else {
-        *bytes_per_pixel = number_of_planes * 2; /* 2 bytes per pixel */
+        snprintf(path, size, "%s.manifest", rptr->stem);
     }
+    return path;
+}
 
-    return (*status);
+/*  Rewrites the manifest with one line per part: the file name, the
+ *  index of its first frame within the capture, and its frame count.
+ */
+static int ser_rollover_manifest(const serrollover* rptr) {
+    char* path = ser_rollover_path(rptr, 0);
+    if (!path) {
+        return MEM_ALLOC;
+    }
+    FILE* manifest = fopen(path, "w");
+    free(path);
+    if (!manifest) {
+        return FILE_OPEN_ERROR;
+    }
+
+    fprintf(manifest, "# cserio rollover manifest\n");
+    size_t first = 0;
+    for (size_t i = 0; i < rptr->part_count; i++) {
+        char* part_path = ser_rollover_path(rptr, i + 1);
+        if (!part_path) {
+            fclose(manifest);
+            return MEM_ALLOC;
+        }
+        const char* name = strrchr(part_path, '/');
+        name = name ? name + 1 : part_path;
+        fprintf(manifest, "%s %lu %lu\n", name, (unsigned long)first, (unsigned long)rptr->part_frames[i]);
+        first += rptr->part_frames[i];
+        free(part_path);
+    }
+
+    return fclose(manifest) ? FILE_CLOSE_ERROR : NO_ERROR;
 }
 
-int ser_get_frame_byte_size(serfile* sptr, unsigned long* byte_size, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_PARAM(byte_size, status);
+/*  Creates the next part with the rollover header. shift moves the
+ *  header date and time, see ser_rollover_append.
+ */
+static int ser_rollover_next_part(serrollover* rptr, int64_t shift, int* status) {
+    if (rptr->part_count == rptr->part_capacity) {
+        size_t new_capacity = ser_grown_capacity(rptr->part_capacity, rptr->part_count + 1);
+        size_t* new_frames = (size_t*)realloc(rptr->part_frames, new_capacity * sizeof(size_t));
+        if (!new_frames) {
+            return (*status = MEM_ALLOC);
+        }
+        rptr->part_frames = new_frames;
+        rptr->part_capacity = new_capacity;
+    }
 
-    unsigned long bytes_per_pixel = 0;
-    ser_get_bytes_per_pixel(sptr, &bytes_per_pixel, status);
-    if (*status) { 
+    char* path = ser_rollover_path(rptr, rptr->part_count + 1);
+    if (!path) {
+        return (*status = MEM_ALLOC);
+    }
+    ser_create_file(&rptr->part, path, status);
+    free(path);
+    if (*status) {
         return (*status);
     }
 
-    int32_t width = sptr->image_width;
-    int32_t height = sptr->image_height;
-
-    *byte_size = bytes_per_pixel * width * height;
+    const serinfo* header = &rptr->header;
+    ser_write_file_id(rptr->part, header->file_id, status);
+    ser_write_lu_id(rptr->part, header->lu_id, status);
+    ser_write_color_id(rptr->part, header->color_id, status);
+    ser_write_little_endian(rptr->part, header->little_endian, status);
+    ser_write_image_width(rptr->part, header->image_width, status);
+    ser_write_image_height(rptr->part, header->image_height, status);
+    ser_write_pixel_depth_per_plane(rptr->part, header->pixel_depth_per_plane, status);
+    ser_write_observer(rptr->part, header->observer, status);
+    ser_write_instrument(rptr->part, header->instrument, status);
+    ser_write_telescope(rptr->part, header->telescope, status);
+    ser_write_date_time(rptr->part, header->date_time > 0 ? header->date_time + shift : header->date_time, status);
+    ser_write_date_time_utc(rptr->part, header->date_time > 0 && header->date_time_utc ? header->date_time_utc + shift : header->date_time_utc, status);
+
+    rptr->part_frames[rptr->part_count] = 0;
+    rptr->part_count += 1;
+    if (*status) {
+        return (*status);
+    }
 
-    return (*status);
+    return (*status = ser_rollover_manifest(rptr));
 }
 
-int ser_read_frame(serfile* sptr, void* dest, size_t idx, int* status) {
+int ser_rollover_create(serrollover** rptr, const char* path, const serinfo* header, uint64_t max_bytes, size_t max_frames, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(dest, status);
+    RETURN_IF_NULL_PARAM(rptr, status);
+    RETURN_IF_NULL_PARAM(header, status);
 
-    if (idx >= sptr->frame_count) {
-        return (*status = INVALID_FRAME_IDX); 
+    if (!path) {
+        return (*status = NULL_PATH);
     }
 
-    unsigned long frame_byte_size = 0;
-    ser_get_frame_byte_size(sptr, &frame_byte_size, status);
-    if (*status) { 
-        return (*status); 
+    serrollover* rollover = (serrollover*)calloc(1, sizeof(serrollover));
+    if (!rollover) {
+        return (*status = MEM_ALLOC);
     }
 
-    unsigned long frame_offset = HDR_SIZE + (frame_byte_size * idx);
+    /* night.ser and night both give night.0001.ser */
+    size_t stem_len = strlen(path);
+    if (stem_len > 4 && !strcmp(path + stem_len - 4, ".ser")) {
+        stem_len -= 4;
+    }
+    rollover->stem = (char*)malloc(stem_len + 1);
+    if (!rollover->stem) {
+        free(rollover);
+        return (*status = MEM_ALLOC);
+    }
+    memcpy(rollover->stem, path, stem_len);
+    rollover->stem[stem_len] = '\0';
 
-    size_t bytes_read = sptr->reader(sptr->io_context, dest, frame_byte_size, frame_offset);
-    if (bytes_read < frame_byte_size) {
-        *status = READ_ERROR;
+    rollover->header = *header;
+    rollover->max_bytes = max_bytes;
+    rollover->max_frames = max_frames;
+
+    unsigned long frame_byte_size = 0;
+    if (!ser_rollover_next_part(rollover, 0, status)) {
+        ser_get_frame_byte_size(rollover->part, &frame_byte_size, status);
+        if (!*status && frame_byte_size == 0) {
+            *status = INVALID_FRAME_SIZE;
+        }
     }
+    if (*status) {
+        /* only remove what was created here, never an existing file */
+        if (rollover->part) {
+            int close_status = 0;
+            ser_close_file(rollover->part, &close_status);
+            for (size_t part = 0; part <= 1; part++) {
+                char* created = ser_rollover_path(rollover, part);
+                if (created) {
+                    remove(created);
+                }
+                free(created);
+            }
+        }
+        free(rollover->part_frames);
+        free(rollover->stem);
+        free(rollover);
+        return (*status);
+    }
+    rollover->frame_byte_size = frame_byte_size;
 
+    *rptr = rollover;
     return (*status);
 }
 
-int ser_append_frame(serfile* sptr, const void* data, uint64_t timestamp, int* status) {
+int ser_rollover_append(serrollover* rptr, const void* data, uint64_t timestamp, int* status) {
 	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-	RETURN_IF_WRITE_ON_READONLY(sptr, status);
+    RETURN_IF_NULL_PARAM(rptr, status);
     RETURN_IF_NULL_PARAM(data, status);
 
-    size_t frame_byte_size = 0;
-    ser_get_frame_byte_size(sptr, &frame_byte_size, status);
-    if (*status) { 
-        return (*status); 
+    if (!rptr->part) {
+        return (*status = NULL_SPTR);
     }
 
-    if (frame_byte_size == 0) {
-        return (*status = INVALID_FRAME_SIZE);
+    size_t frames = rptr->part_frames[rptr->part_count - 1];
+    bool full = rptr->max_frames && frames >= rptr->max_frames;
+    if (rptr->max_bytes && frames > 0) {
+        uint64_t unit = rptr->frame_byte_size + (rptr->part->has_trailer ? sizeof(int64_t) : 0);
+        uint64_t part_size = 0;
+        full = full || !ser_offset_of(HDR_SIZE, frames + 1, unit, &part_size) || part_size > rptr->max_bytes;
     }
 
-    size_t frame_count = sptr->frame_count;
-    unsigned long frame_offset = HDR_SIZE + (frame_byte_size * frame_count);
-
-    size_t bytes_written = sptr->writer(
-            sptr->io_context,
-            data,
-            frame_byte_size,
-            frame_offset
-    );
-    if (bytes_written < frame_byte_size) {
-        return (*status = IMAGE_WRITE_WARN);
+    if (full) {
+        ser_close_file(rptr->part, status);
+        rptr->part = NULL;
+        if (*status) {
+            return (*status);
+        }
+        /* the header time of a part is that of its first frame */
+        int64_t start = rptr->header.date_time_utc ? rptr->header.date_time_utc : rptr->header.date_time;
+        if (ser_rollover_next_part(rptr, (int64_t)timestamp - start, status)) {
+            return (*status);
+        }
     }
-    sptr->frame_count += 1;
-    sptr->writer(sptr->io_context, &sptr->frame_count, FRAMECOUNT_LEN, FRAMECOUNT_KEY);
 
-    if (sptr->has_trailer) {
-        sptr->timestamp_count += 1;
-        size_t new_trailer_size = sptr->timestamp_count * sizeof(int64_t);
-        sptr->timestamps = (int64_t*)realloc(sptr->timestamps, new_trailer_size);
-        sptr->timestamps[sptr->timestamp_count - 1] = timestamp;
+    if (ser_append_frame(rptr->part, data, timestamp, status)) {
+        return (*status);
     }
+    rptr->part_frames[rptr->part_count - 1] += 1;
 
     return (*status);
 }
 
-/*-------------------- Trailer Routines --------------------*/
-
-int ser_read_timestamp(serfile* sptr, int64_t* dest, size_t idx, int* status) {
-	RETURN_IF_STATUS_IS_ERROR(status);
-	RETURN_IF_NULL_SPTR(sptr, status);
-    RETURN_IF_NULL_DEST_BUFF(dest, status);
+int ser_rollover_close(serrollover* rptr, int* status) {
+    RETURN_IF_NULL_PARAM(rptr, status);
 
-    if (!sptr->has_trailer) {
-        return (*status = TRAILER_DNE);
+    if (rptr->part) {
+        ser_close_file(rptr->part, status);
     }
 
-    if (idx >= sptr->timestamp_count) {
-        return (*status = INVALID_TRAILER_IDX); 
+    int error = ser_rollover_manifest(rptr);
+    if (error && !*status) {
+        *status = error;
     }
 
-    *dest = sptr->timestamps[idx];
-
+    free(rptr->part_frames);
+    free(rptr->stem);
+    free(rptr);
     return (*status);
 }
 
@@ -1362,7 +6235,7 @@ int ser_create_memory(serfile** sptr, int* status) {
 	RETURN_IF_SPTR_OCCUPIED(sptr, status);
 
     /* allocate memory for serfile */
-    *sptr = (serfile*)malloc(sizeof(serfile));
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
     if (!*sptr) {
         return (*status = MEM_ALLOC);
     }
@@ -1371,12 +6244,18 @@ int ser_create_memory(serfile** sptr, int* status) {
     serMem* ser_data = (serMem*)malloc(sizeof(serMem));
     ser_data->data = (uint8_t*)malloc(HDR_SIZE);
     ser_data->size = HDR_SIZE;
+    ser_data->capacity = HDR_SIZE;
     ser_data->owns_buffer = true;
 
     /* general setup */
     (*sptr)->io_context = ser_data;
     (*sptr)->reader = ser_memory_read;
     (*sptr)->writer = ser_memory_write;
+    (*sptr)->sizer = ser_memory_size;
+    (*sptr)->flusher = NULL;
+    (*sptr)->closer = ser_memory_close;
+    (*sptr)->lender = ser_memory_lend;
+    (*sptr)->reserver = ser_memory_reserve;
     (*sptr)->access_mode = READWRITE;
 
     /* intialize file metadata */
@@ -1402,7 +6281,7 @@ int ser_open_view(serfile** sptr, uint8_t* data, size_t size, int mode, int* sta
     }
 
     /* allocate memory for serfile */
-    *sptr = (serfile*)malloc(sizeof(serfile));
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
     if (!(*sptr)) {
         return (*status = MEM_ALLOC);
     }
@@ -1411,58 +6290,28 @@ int ser_open_view(serfile** sptr, uint8_t* data, size_t size, int mode, int* sta
     serMem* ser_data = (serMem*)malloc(sizeof(serMem));
     ser_data->data = data;
     ser_data->size = size;
+    ser_data->capacity = size;
     ser_data->owns_buffer = false;
 
     /* general setup */
     (*sptr)->io_context = ser_data;
     (*sptr)->reader = ser_memory_read;
     (*sptr)->writer = ser_memory_write;
+    (*sptr)->sizer = ser_memory_size;
+    (*sptr)->flusher = NULL;
+    (*sptr)->closer = ser_memory_close;
+    (*sptr)->lender = ser_memory_lend;
+    (*sptr)->reserver = NULL;
     (*sptr)->access_mode = mode == READWRITE ? READWRITE : READONLY;
-    (*sptr)->reader(ser_data, (*sptr)->file_id, FILEID_LEN, FILEID_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->lu_id, LUID_LEN, LUID_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->color_id, COLORID_LEN, COLORID_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->little_endian, LITTLEENDIAN_LEN, LITTLEENDIAN_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->image_width, IMAGEWIDTH_LEN, IMAGEWIDTH_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->image_height, IMAGEHEIGHT_LEN, IMAGEHEIGHT_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->pixel_depth_per_plane, PIXELDEPTHPERPLANE_LEN, PIXELDEPTHPERPLANE_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->frame_count, FRAMECOUNT_LEN, FRAMECOUNT_KEY);
-    (*sptr)->reader(ser_data, (*sptr)->observer, OBSERVER_LEN, OBSERVER_KEY);
-    (*sptr)->reader(ser_data, (*sptr)->instrument, INSTRUMENT_LEN, INSTRUMENT_KEY);
-    (*sptr)->reader(ser_data, (*sptr)->telescope, TELESCOPE_LEN, TELESCOPE_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->date_time, DATETIME_LEN, DATETIME_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->date_time_utc, DATETIMEUTC_LEN, DATETIMEUTC_KEY);
-    (*sptr)->has_trailer = (*sptr)->date_time <= 0 ? false : true;
-    (*sptr)->timestamps = NULL;
-    (*sptr)->timestamp_count = 0;
-
-    /* determine if valid hdr + data or hdr + data + trailer */
-    size_t frame_byte_size = 0;
-    ser_get_frame_byte_size(*sptr, &frame_byte_size, status);
-    size_t trailer_offset = HDR_SIZE + (*sptr)->frame_count * frame_byte_size;
+    (*sptr)->salvage = mode == READSALVAGE;
 
-    if ((*sptr)->has_trailer) {
-        if (size == trailer_offset + (*sptr)->frame_count * sizeof(uint64_t)) {
-            (*sptr)->timestamps = (int64_t*)realloc((*sptr)->timestamps, (*sptr)->frame_count * sizeof(uint64_t));
-            (*sptr)->timestamp_count = (*sptr)->frame_count;
-            (*sptr)->reader(
-                    (*sptr)->io_context,
-                    (*sptr)->timestamps,
-                    (*sptr)->frame_count * sizeof(uint64_t),
-                    trailer_offset
-            );
-            return (*status);
-        }
-    } else {
-        if (size == trailer_offset) {
-            return (*status);
-        }
+    if (ser_open_initializations(*sptr, size, status)) {
+        ser_memory_close(ser_data);
+        free((*sptr));
+        *sptr = NULL;
     }
 
-    /* if reached, invalid structure */
-    free(((serMem*)(*sptr)->io_context));
-    free((*sptr));
-    *sptr = NULL;
-    return (*status = INVALID_STRUCTURE);
+    return (*status);
 }
 
 int ser_open_memory(serfile** sptr, const uint8_t* data, size_t size, int mode, int* status) {
@@ -1477,7 +6326,7 @@ int ser_open_memory(serfile** sptr, const uint8_t* data, size_t size, int mode,
     }
 
     /* allocate memory for serfile */
-    *sptr = (serfile*)malloc(sizeof(serfile));
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
     if (!(*sptr)) {
         return (*status = MEM_ALLOC);
     }
@@ -1489,95 +6338,143 @@ int ser_open_memory(serfile** sptr, const uint8_t* data, size_t size, int mode,
         memcpy(ser_data->data, data, size);
     }
     ser_data->size = size;
+    ser_data->capacity = size;
     ser_data->owns_buffer = true;
 
     /* general setup */
     (*sptr)->io_context = ser_data;
     (*sptr)->reader = ser_memory_read;
     (*sptr)->writer = ser_memory_write;
+    (*sptr)->sizer = ser_memory_size;
+    (*sptr)->flusher = NULL;
+    (*sptr)->closer = ser_memory_close;
+    (*sptr)->lender = ser_memory_lend;
+    (*sptr)->reserver = ser_memory_reserve;
     (*sptr)->access_mode = mode == READWRITE ? READWRITE : READONLY;
-    (*sptr)->reader(ser_data, (*sptr)->file_id, FILEID_LEN, FILEID_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->lu_id, LUID_LEN, LUID_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->color_id, COLORID_LEN, COLORID_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->little_endian, LITTLEENDIAN_LEN, LITTLEENDIAN_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->image_width, IMAGEWIDTH_LEN, IMAGEWIDTH_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->image_height, IMAGEHEIGHT_LEN, IMAGEHEIGHT_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->pixel_depth_per_plane, PIXELDEPTHPERPLANE_LEN, PIXELDEPTHPERPLANE_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->frame_count, FRAMECOUNT_LEN, FRAMECOUNT_KEY);
-    (*sptr)->reader(ser_data, (*sptr)->observer, OBSERVER_LEN, OBSERVER_KEY);
-    (*sptr)->reader(ser_data, (*sptr)->instrument, INSTRUMENT_LEN, INSTRUMENT_KEY);
-    (*sptr)->reader(ser_data, (*sptr)->telescope, TELESCOPE_LEN, TELESCOPE_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->date_time, DATETIME_LEN, DATETIME_KEY);
-    (*sptr)->reader(ser_data, &(*sptr)->date_time_utc, DATETIMEUTC_LEN, DATETIMEUTC_KEY);
-    (*sptr)->has_trailer = (*sptr)->date_time <= 0 ? false : true;
-    (*sptr)->timestamps = NULL;
-    (*sptr)->timestamp_count = 0;
-
-    /* determine if valid hdr + data or hdr + data + trailer */
-    size_t frame_byte_size = 0;
-    ser_get_frame_byte_size(*sptr, &frame_byte_size, status);
-    size_t trailer_offset = HDR_SIZE + (*sptr)->frame_count * frame_byte_size;
+    (*sptr)->salvage = mode == READSALVAGE;
 
-    if ((*sptr)->has_trailer) {
-        if (size == trailer_offset + (*sptr)->frame_count * sizeof(uint64_t)) {
-            (*sptr)->timestamps = (int64_t*)realloc((*sptr)->timestamps, (*sptr)->frame_count * sizeof(uint64_t));
-            (*sptr)->timestamp_count = (*sptr)->frame_count;
-            (*sptr)->reader(
-                    (*sptr)->io_context,
-                    (*sptr)->timestamps,
-                    (*sptr)->frame_count * sizeof(uint64_t),
-                    trailer_offset
-            );
-            return (*status);
-        }
-    } else {
-        if (size == trailer_offset) {
-            return (*status);
-        }
+    if (ser_open_initializations(*sptr, size, status)) {
+        ser_memory_close(ser_data);
+        free((*sptr));
+        *sptr = NULL;
     }
 
-    /* if reached, invalid structure */
-    free(((serMem*)(*sptr)->io_context)->data);
-    free(((serMem*)(*sptr)->io_context));
-    free((*sptr));
-    *sptr = NULL;
-    return (*status = INVALID_STRUCTURE);
+    return (*status);
 }
 
 int ser_close_memory(serfile* sptr, int* status) {
 	RETURN_IF_NULL_SPTR(sptr, status);
 
-    if (sptr->timestamps && sptr->access_mode == READWRITE) {
-        size_t image_frame_byte_size = 0;
-        ser_get_frame_byte_size(sptr, &image_frame_byte_size, status);
-        size_t image_data_size = sptr->frame_count * image_frame_byte_size;
+#if defined(CSERIO_POSIX)
+    ser_prefetch_stop(sptr);
+    int append_error = ser_appender_stop(sptr);
+    if (append_error) {
+        *status = append_error;
+    }
+#endif
 
-        size_t trailer_offset = HDR_SIZE + image_data_size;
-        size_t trailer_size = sizeof(int64_t) * sptr->timestamp_count;
+    bool durable = true;
+    if (sptr->uncommitted_frames && !ser_commit_frame_count(sptr)) {
+        *status = FILE_CLOSE_ERROR;
+        durable = false;
+    }
 
-        size_t bytes_written = sptr->writer(
-                sptr->io_context,
-                sptr->timestamps,
-                trailer_size,
-                trailer_offset
-        );
-        if (bytes_written != trailer_size) {
+    if (sptr->timestamps && sptr->access_mode == READWRITE) {
+        if (!ser_write_trailer(sptr)) {
             *status = TRAILER_CLOSE_WARN;
+            durable = false;
         }
-        free(sptr->timestamps);
-    }
-
-    serMem* memory_io = (serMem*)(sptr->io_context);
-    if (memory_io->owns_buffer) {
-        free(memory_io->data);
     }
+    ser_release_timestamps(sptr);
+    ser_journal_close(sptr, durable);
 
-    free(sptr->io_context);
+    sptr->closer(sptr->io_context);
     free(sptr);
     sptr = NULL;
     return (*status);
 }
 
+/*-------------------- Custom-Backed SER Access Routines --------------------*/
+
+static void ser_custom_setup(serfile* sptr, const serbackend* backend, int mode) {
+    sptr->io_context = backend->context;
+    sptr->reader = backend->reader;
+    sptr->writer = backend->writer;
+    sptr->sizer = backend->sizer;
+    sptr->flusher = backend->flusher;
+    sptr->closer = backend->closer;
+    sptr->lender = backend->lender;
+    sptr->access_mode = mode == READWRITE ? READWRITE : READONLY;
+}
+
+int ser_create_custom(serfile** sptr, const serbackend* backend, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTRPTR(sptr, status);
+	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+    RETURN_IF_NULL_PARAM(backend, status);
+    RETURN_IF_NULL_PARAM(backend->context, status);
+    RETURN_IF_NULL_PARAM(backend->reader, status);
+    RETURN_IF_NULL_PARAM(backend->writer, status);
+    RETURN_IF_NULL_PARAM(backend->sizer, status);
+
+    /* allocate memory for serfile */
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
+    if (!*sptr) {
+        return (*status = MEM_ALLOC);
+    }
+
+    /* general setup */
+    ser_custom_setup(*sptr, backend, READWRITE);
+
+    /* intialize file metadata */
+    ser_header_initializations(*sptr);
+
+    /* initialize trailer */
+    (*sptr)->has_trailer = (*sptr)->date_time <= 0 ? false : true;
+    (*sptr)->timestamps = NULL;
+    (*sptr)->timestamp_count = 0;
+
+    return (*status);
+}
+
+int ser_open_custom(serfile** sptr, const serbackend* backend, int mode, int* status) {
+	RETURN_IF_STATUS_IS_ERROR(status);
+	RETURN_IF_NULL_SPTRPTR(sptr, status);
+	RETURN_IF_SPTR_OCCUPIED(sptr, status);
+    RETURN_IF_NULL_PARAM(backend, status);
+    RETURN_IF_NULL_PARAM(backend->context, status);
+    RETURN_IF_NULL_PARAM(backend->reader, status);
+    RETURN_IF_NULL_PARAM(backend->sizer, status);
+
+    /* a writable handle needs somewhere to write to */
+    if (mode == READWRITE && !backend->writer) {
+        return (*status = INVALID_SET_VALUE);
+    }
+
+    /* determine validity of header */
+    uint64_t size = backend->sizer(backend->context);
+    if (size < HDR_SIZE) {
+        return (*status = INVALID_STRUCTURE);
+    }
+
+    /* allocate memory for serfile */
+    *sptr = (serfile*)calloc(1, sizeof(serfile));
+    if (!*sptr) {
+        return (*status = MEM_ALLOC);
+    }
+
+    /* general setup */
+    ser_custom_setup(*sptr, backend, mode);
+
+    /* the backend is left open on failure, it belongs to the caller */
+    if (ser_open_initializations(*sptr, size, status)) {
+        free((*sptr));
+        *sptr = NULL;
+    }
+
+    return (*status);
+}
+
 #endif /* CSERIO_IMPLEMENTATION */
 
 #ifdef __cplusplus
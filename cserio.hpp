@@ -0,0 +1,367 @@
+#ifndef CSERIO_HPP
+#define CSERIO_HPP
+
+/*
+ *  Optional C++20 coroutine interface on top of cserio.h.
+ *
+ *  A cserio::engine turns frame reads and appends into awaitable
+ *  operations. Reads are served by a serasync queue (io_uring on 
+ *  Linux), appends by ser_append_frame_async. Coroutines are only 
+ *  ever resumed from engine::poll or engine::run, so any number of 
+ *  operations can be in flight while the coroutines themselves run
+ *  on the one thread that drives the engine.
+ *
+ *  The library itself must still be compiled once as C, see cserio.c.
+ */
+
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+
+#include "cserio.h"
+
+
+namespace cserio {
+
+/*  Coroutine that starts running immediately and frees itself when
+ *  its body returns. Enough to drive an engine, any other coroutine
+ *  type can await engine operations just as well.
+ */
+struct task {
+    struct promise_type {
+        task get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+class engine;
+
+namespace detail {
+
+/*  A read or append waiting for its turn, in flight, or finished and
+ *  waiting for its coroutine to be resumed.
+ */
+struct operation {
+    engine*                 owner;
+    std::coroutine_handle<> handle;
+    operation*              next;
+    bool                    append;
+    void*                   dest;
+    const void*             data;
+    std::size_t             idx;
+    std::uint64_t           timestamp;
+    int                     status;
+};
+
+/*  Intrusive FIFO of operations.
+ */
+struct operation_list {
+    operation* head = nullptr;
+    operation* tail = nullptr;
+
+    void push(operation* op) noexcept {
+        op->next = nullptr;
+        if (tail) {
+            tail->next = op;
+        } else {
+            head = op;
+        }
+        tail = op;
+    }
+
+    operation* pop() noexcept {
+        operation* op = head;
+        if (op) {
+            head = op->next;
+            if (!head) {
+                tail = nullptr;
+            }
+        }
+        return op;
+    }
+
+    void push_front(operation* op) noexcept {
+        op->next = head;
+        head = op;
+        if (!tail) {
+            tail = op;
+        }
+    }
+
+    operation_list take() noexcept {
+        operation_list taken = *this;
+        head = tail = nullptr;
+        return taken;
+    }
+};
+
+} // namespace detail
+
+/*  Awaitable frame operation returned by engine::read_frame and
+ *  engine::append_frame. co_await yields the status the equivalent
+ *  ser_read_frame or ser_append_frame call would have reported.
+ */
+class frame_op {
+public:
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) noexcept;
+    int await_resume() const noexcept { return op_.status; }
+
+private:
+    friend class engine;
+    frame_op() noexcept : op_{} {}
+
+    detail::operation op_;
+};
+
+class engine {
+public:
+    /*  @brief  Create an engine for a serfile.
+     *
+     *  Up to depth reads and depth appends are handed to the library
+     *  at once, further operations wait in the engine in the order
+     *  they were awaited. Builds without asynchronous reads fall back
+     *  to reading frames synchronously when they are dispatched.
+     *
+     *  @param  sptr        (I)     - Pointer to serfile.
+     *  @param  depth       (I)     - Operations handed to the library.
+     *  @param  status      (IO)    - Error status.
+     */
+    engine(serfile* sptr, std::size_t depth, int* status) noexcept : sptr_(sptr) {
+        if (*status) {
+            status_ = *status;
+            return;
+        }
+
+        ser_async_create(&aptr_, sptr, depth, status);
+        if (*status == NOT_SUPPORTED) {
+            *status = NO_ERROR;
+        }
+        ser_set_append_depth(sptr, depth, status);
+        status_ = *status;
+    }
+
+    /*  Waits for every operation, resuming their coroutines, then
+     *  destroys the read queue. The serfile is not closed.
+     */
+    ~engine() {
+        run();
+        if (aptr_) {
+            int status = 0;
+            ser_async_destroy(aptr_, &status);
+        }
+    }
+
+    engine(const engine&) = delete;
+    engine& operator=(const engine&) = delete;
+
+    /*  @brief  Read the frame at the index into dest.
+     *
+     *  dest must hold a whole frame and stay valid until the awaiting
+     *  coroutine resumes. Reads wait for appends awaited before them.
+     */
+    frame_op read_frame(void* dest, std::size_t idx) noexcept {
+        frame_op op;
+        op.op_.owner = this;
+        op.op_.dest = dest;
+        op.op_.idx = idx;
+        return op;
+    }
+
+    /*  @brief  Append a frame and its timestamp.
+     *
+     *  data must stay valid and unchanged until the awaiting coroutine
+     *  resumes. Frames are appended in the order they are awaited,
+     *  after any reads awaited before them have finished.
+     */
+    frame_op append_frame(const void* data, std::uint64_t timestamp) noexcept {
+        frame_op op;
+        op.op_.owner = this;
+        op.op_.append = true;
+        op.op_.data = data;
+        op.op_.timestamp = timestamp;
+        return op;
+    }
+
+    /*  @brief  Resume the coroutines whose operations have finished.
+     *
+     *  Never blocks. Returns the number of coroutines resumed.
+     */
+    std::size_t poll() noexcept {
+        collect(false);
+        return resume_ready();
+    }
+
+    /*  @brief  Resume coroutines until no operation is left.
+     *
+     *  Blocks while operations are in flight. Returns NO_ERROR, or
+     *  the status of the read queue if it fails.
+     */
+    int run() noexcept {
+        while (reads_in_flight_ || appends_in_flight_ || pending_.head || ready_.head) {
+            if (resume_ready()) {
+                continue;
+            }
+            if (int status = collect(true)) {
+                return status;
+            }
+        }
+        return NO_ERROR;
+    }
+
+    /*  Number of operations awaited and not yet resumed.
+     */
+    std::size_t outstanding() const noexcept { return outstanding_; }
+
+private:
+    friend class frame_op;
+
+    static constexpr std::size_t collect_batch = 32;
+
+    void enqueue(detail::operation* op) noexcept {
+        outstanding_ += 1;
+        if (status_) {
+            op->status = status_;
+            ready_.push(op);
+            return;
+        }
+        pending_.push(op);
+        dispatch();
+    }
+
+    /*  Hands waiting operations to the library in order. A read and
+     *  an append are never in flight together, as reads may not
+     *  overlap writes to the same serfile.
+     */
+    void dispatch() noexcept {
+        while (detail::operation* op = pending_.head) {
+            if (op->append ? reads_in_flight_ : appends_in_flight_) {
+                return;
+            }
+
+            /* once handed over, op may complete on another thread */
+            pending_.pop();
+            int status = 0;
+            if (op->append) {
+                ser_append_frame_async(sptr_, op->data, op->timestamp, on_appended, op, &status);
+            } else if (aptr_) {
+                ser_async_submit(aptr_, op->dest, op->idx, op, &status);
+            } else {
+                ser_read_frame(sptr_, op->dest, op->idx, &status);
+            }
+            /* slots are freed before their callback, so appends are in flight to wait for */
+            if (status == ASYNC_QUEUE_FULL) {
+                pending_.push_front(op);
+                return;
+            }
+
+            if (status || (!op->append && !aptr_)) {
+                op->status = status;
+                ready_.push(op);
+            } else if (op->append) {
+                appends_in_flight_ += 1;
+            } else {
+                reads_in_flight_ += 1;
+            }
+        }
+    }
+
+    /*  Called by the background writer, which must not be held up.
+     */
+    static void on_appended(const void*, void* user, int status) {
+        detail::operation* op = static_cast<detail::operation*>(user);
+        engine* owner = op->owner;
+        op->status = status;
+
+        std::lock_guard<std::mutex> lock(owner->lock_);
+        owner->appended_.push(op);
+        owner->appended_cond_.notify_one();
+    }
+
+    /*  Moves finished operations to the ready list, blocking for the
+     *  first one when asked to, and refills the library. Only reads
+     *  or only appends are ever in flight.
+     */
+    int collect(bool blocking) noexcept {
+        if (reads_in_flight_) {
+            sercompletion completions[collect_batch];
+            std::size_t count = 0;
+            int status = 0;
+            if (blocking) {
+                ser_async_wait(aptr_, completions, collect_batch, &count, &status);
+            } else {
+                ser_async_poll(aptr_, completions, collect_batch, &count, &status);
+            }
+            if (status) {
+                return status;
+            }
+
+            for (std::size_t i = 0; i < count; i++) {
+                detail::operation* op = static_cast<detail::operation*>(completions[i].user_data);
+                op->status = completions[i].status;
+                ready_.push(op);
+            }
+            reads_in_flight_ -= count;
+        }
+
+        if (appends_in_flight_) {
+            std::unique_lock<std::mutex> lock(lock_);
+            if (blocking) {
+                appended_cond_.wait(lock, [this] { return appended_.head != nullptr; });
+            }
+            detail::operation_list appended = appended_.take();
+            lock.unlock();
+
+            while (detail::operation* op = appended.pop()) {
+                appends_in_flight_ -= 1;
+                ready_.push(op);
+            }
+        }
+
+        dispatch();
+        return NO_ERROR;
+    }
+
+    /*  Resumes the coroutines that were ready on entry. Those may
+     *  await again, which only queues more operations.
+     */
+    std::size_t resume_ready() noexcept {
+        detail::operation_list ready = ready_.take();
+        std::size_t resumed = 0;
+        while (detail::operation* op = ready.pop()) {
+            outstanding_ -= 1;
+            resumed += 1;
+            op->handle.resume();
+        }
+        return resumed;
+    }
+
+    serfile*                sptr_;
+    serasync*               aptr_ = nullptr;
+    int                     status_ = 0;
+
+    detail::operation_list  pending_;
+    detail::operation_list  ready_;
+    std::size_t             reads_in_flight_ = 0;
+    std::size_t             appends_in_flight_ = 0;
+    std::size_t             outstanding_ = 0;
+
+    std::mutex              lock_;
+    std::condition_variable appended_cond_;
+    detail::operation_list  appended_;
+};
+
+inline void frame_op::await_suspend(std::coroutine_handle<> handle) noexcept {
+    op_.handle = handle;
+    op_.owner->enqueue(&op_);
+}
+
+} // namespace cserio
+
+#endif /* CSERIO_HPP */
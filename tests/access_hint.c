@@ -0,0 +1,181 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+START_TEST(access_pattern_success) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int patterns[] = {ACCESS_SEQUENTIAL, ACCESS_RANDOM, ACCESS_ONCE, ACCESS_NORMAL};
+    uint8_t buffer[50 * 50];
+    for (size_t i = 0; i < sizeof(patterns) / sizeof(patterns[0]); i++) {
+        ser_set_access_pattern(test_ser, patterns[i], &status);
+        ck_assert_int_eq(status, NO_ERROR);
+
+        ser_read_frame(test_ser, buffer, i % 3, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(access_once_mapped) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(&test_ser, filepath, READONLY, &status);
+    ser_set_access_pattern(test_ser, ACCESS_ONCE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* dropped pages fault back in from the file */
+    uint8_t buffer[50 * 50];
+    for (int i = 0; i < 6; i++) {
+        ser_read_frame(test_ser, buffer, i % 3, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_mem_eq(buffer, test_data_3x50.data + (i % 3) * sizeof(buffer), sizeof(buffer));
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(access_pattern_invalid) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(&test_ser, (uint8_t*)&test_data_3x50, sizeof(test_data_3x50), READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_set_access_pattern(test_ser, ACCESS_SEQUENTIAL, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_set_access_pattern(test_ser, -1, &status);
+    ck_assert_int_eq(status, INVALID_SET_VALUE);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(prefetch_sequential_read) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = test_data_3x50;
+    for (size_t i = 0; i < 3; i++) {
+        memset(test_data.data + i * 50 * 50, (int)(i + 1), 50 * 50);
+    }
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_set_prefetch(test_ser, 2, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t buffer[50 * 50];
+    for (size_t i = 0; i < 3; i++) {
+        ser_read_frame(test_ser, buffer, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_mem_eq(buffer, test_data.data + i * sizeof(buffer), sizeof(buffer));
+    }
+
+    /* restart from a random position, then disable */
+    ser_read_frame(test_ser, buffer, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ser_set_prefetch(test_ser, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* left running for close to stop */
+    ser_set_prefetch(test_ser, 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(prefetch_not_supported) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(&test_ser, (uint8_t*)&test_data_3x50, sizeof(test_data_3x50), READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_set_prefetch(test_ser, 2, &status);
+    ck_assert_int_eq(status, NOT_SUPPORTED);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+Suite* access_hint_suite() {
+    Suite* s;
+    s = suite_create("Access Hint");
+
+    TCase* tc_access_pattern = tcase_create("access_pattern");
+    tcase_add_test(tc_access_pattern, access_pattern_success);
+    tcase_add_test(tc_access_pattern, access_once_mapped);
+    tcase_add_test(tc_access_pattern, access_pattern_invalid);
+    suite_add_tcase(s, tc_access_pattern);
+
+    TCase* tc_prefetch = tcase_create("prefetch");
+    tcase_add_test(tc_prefetch, prefetch_sequential_read);
+    tcase_add_test(tc_prefetch, prefetch_not_supported);
+    suite_add_tcase(s, tc_prefetch);
+
+    return s;
+}
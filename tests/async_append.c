@@ -0,0 +1,384 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+#define ASYNC_APPEND_FRAMES     50
+#define ASYNC_APPEND_BUFFERS    3
+#define ASYNC_APPEND_FRAME_SIZE (50 * 50)
+
+typedef struct {
+    uint8_t     buffers[ASYNC_APPEND_BUFFERS][ASYNC_APPEND_FRAME_SIZE];
+    int         in_flight[ASYNC_APPEND_BUFFERS];
+    size_t      completed;
+    int         statuses[ASYNC_APPEND_FRAMES];
+} async_append_state;
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+static void append_done(const void* data, void* user, int status) {
+    async_append_state* state = (async_append_state*)user;
+    size_t buffer = ((const uint8_t*)data - state->buffers[0]) / ASYNC_APPEND_FRAME_SIZE;
+    state->statuses[state->completed++] = status;
+    __atomic_store_n(&state->in_flight[buffer], 0, __ATOMIC_RELEASE);
+}
+
+/* frame i is filled with i + 1 and cycles through the buffers */
+static void append_frames(serfile* test_ser, async_append_state* state) {
+    for (int i = 0; i < ASYNC_APPEND_FRAMES; i++) {
+        size_t buffer = i % ASYNC_APPEND_BUFFERS;
+        while (__atomic_load_n(&state->in_flight[buffer], __ATOMIC_ACQUIRE)) {
+            usleep(100);
+        }
+        memset(state->buffers[buffer], i + 1, ASYNC_APPEND_FRAME_SIZE);
+        state->in_flight[buffer] = 1;
+
+        int status = 0;
+        ser_append_frame_async(
+                test_ser,
+                state->buffers[buffer],
+                TEST_TIMESTAMP_VALUE + i,
+                append_done,
+                state,
+                &status
+        );
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+}
+
+static void check_frames(serfile* test_ser, int frames) {
+    int status = 0;
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, frames);
+
+    uint8_t buffer[ASYNC_APPEND_FRAME_SIZE];
+    for (int i = 0; i < frames; i++) {
+        ser_read_frame(test_ser, buffer, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(buffer[0], i + 1);
+        ck_assert_int_eq(buffer[ASYNC_APPEND_FRAME_SIZE - 1], i + 1);
+
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, i, &status);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + i);
+    }
+}
+
+/* a backend whose frame writes wait until the gate opens */
+typedef struct {
+    uint8_t data[HDR_SIZE + 2 * ASYNC_APPEND_FRAME_SIZE];
+    size_t size;
+    int open;
+} gated_store;
+
+static size_t gated_read(void* context, void* buffer, size_t size, uint64_t offset) {
+    gated_store* store = (gated_store*)context;
+    if (offset + size > store->size) {
+        return 0;
+    }
+    memcpy(buffer, store->data + offset, size);
+    return size;
+}
+
+static size_t gated_write(void* context, const void* data, size_t size, uint64_t offset) {
+    gated_store* store = (gated_store*)context;
+    while (offset >= HDR_SIZE && !__atomic_load_n(&store->open, __ATOMIC_ACQUIRE)) {
+        usleep(1000);
+    }
+    if (offset + size > sizeof(store->data)) {
+        return 0;
+    }
+    memcpy(store->data + offset, data, size);
+    if (offset + size > store->size) {
+        store->size = offset + size;
+    }
+    return size;
+}
+
+static uint64_t gated_size(void* context) {
+    return ((gated_store*)context)->size;
+}
+
+START_TEST(async_append_file) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_file(&test_ser, filepath, &status);
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ser_write_date_time(test_ser, TEST_TIMESTAMP_VALUE, &status);
+    ser_set_append_depth(test_ser, ASYNC_APPEND_BUFFERS, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static async_append_state state;
+    memset(&state, 0, sizeof(state));
+    append_frames(test_ser, &state);
+
+    /* closing completes every queued frame */
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(state.completed, ASYNC_APPEND_FRAMES);
+    for (int i = 0; i < ASYNC_APPEND_FRAMES; i++) {
+        ck_assert_int_eq(state.statuses[i], NO_ERROR);
+    }
+
+    test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_frames(test_ser, ASYNC_APPEND_FRAMES);
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(async_append_mixed) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ser_write_date_time(test_ser, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static async_append_state state;
+    memset(&state, 0, sizeof(state));
+    append_frames(test_ser, &state);
+
+    /* a synchronous append lands after the queued ones */
+    uint8_t image_data[ASYNC_APPEND_FRAME_SIZE];
+    memset(image_data, ASYNC_APPEND_FRAMES + 1, sizeof(image_data));
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE + ASYNC_APPEND_FRAMES, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(state.completed, ASYNC_APPEND_FRAMES);
+
+    check_frames(test_ser, ASYNC_APPEND_FRAMES + 1);
+
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(async_append_queue_full) {
+    static gated_store store;
+    memset(&store, 0, sizeof(store));
+    serbackend backend = {
+        .context = &store,
+        .reader = gated_read,
+        .writer = gated_write,
+        .sizer = gated_size,
+        .flusher = NULL,
+        .closer = NULL,
+        .lender = NULL
+    };
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_custom(&test_ser, &backend, &status);
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ser_set_append_depth(test_ser, 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static async_append_state state;
+    memset(&state, 0, sizeof(state));
+    ser_append_frame_async(test_ser, state.buffers[0], 0, append_done, &state, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the writer holds the only slot until the gate opens */
+    ser_append_frame_async(test_ser, state.buffers[1], 0, append_done, &state, &status);
+    ck_assert_int_eq(status, ASYNC_QUEUE_FULL);
+
+    status = 0;
+    __atomic_store_n(&store.open, 1, __ATOMIC_RELEASE);
+    ser_flush(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(state.completed, 1);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 1);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+typedef struct {
+    serfile*    ser;
+    uint8_t     buffer[ASYNC_APPEND_FRAME_SIZE];
+    int         queued;
+    int         statuses[ASYNC_APPEND_FRAMES];
+} chained_append_state;
+
+/* queues the next frame from the completion of the previous one */
+static void append_next(const void* data, void* user, int status) {
+    (void)data;
+    chained_append_state* state = (chained_append_state*)user;
+    state->statuses[state->queued - 1] = status;
+    if (state->queued == ASYNC_APPEND_FRAMES) {
+        return;
+    }
+
+    int queue_status = 0;
+    state->queued += 1;
+    ser_append_frame_async(
+            state->ser,
+            state->buffer,
+            TEST_TIMESTAMP_VALUE + state->queued - 1,
+            append_next,
+            state,
+            &queue_status
+    );
+    if (queue_status) {
+        state->statuses[state->queued - 1] = queue_status;
+        state->queued = ASYNC_APPEND_FRAMES;
+    }
+}
+
+START_TEST(async_append_from_done) {
+    int status = 0;
+    static chained_append_state state;
+    memset(&state, 0, sizeof(state));
+    ser_create_memory(&state.ser, &status);
+    ser_write_image_width(state.ser, 50, &status);
+    ser_write_image_height(state.ser, 50, &status);
+    ser_write_date_time(state.ser, TEST_TIMESTAMP_VALUE, &status);
+    ser_set_append_depth(state.ser, 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the only slot is free again by the time done runs */
+    state.queued = 1;
+    ser_append_frame_async(state.ser, state.buffer, TEST_TIMESTAMP_VALUE, append_next, &state, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_flush(state.ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    for (int i = 0; i < ASYNC_APPEND_FRAMES; i++) {
+        ck_assert_int_eq(state.statuses[i], NO_ERROR);
+    }
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(state.ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, ASYNC_APPEND_FRAMES);
+
+    ser_close_memory(state.ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(async_append_errors) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* without a frame size every queued frame fails */
+    static async_append_state state;
+    memset(&state, 0, sizeof(state));
+    for (int i = 0; i < ASYNC_APPEND_BUFFERS; i++) {
+        ser_append_frame_async(test_ser, state.buffers[i], 0, append_done, &state, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+    ser_set_append_depth(test_ser, 0, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_SIZE);
+    ck_assert_int_eq(state.completed, ASYNC_APPEND_BUFFERS);
+    for (int i = 0; i < ASYNC_APPEND_BUFFERS; i++) {
+        ck_assert_int_eq(state.statuses[i], INVALID_FRAME_SIZE);
+    }
+
+    status = 0;
+    ser_append_frame_async(test_ser, NULL, 0, append_done, &state, &status);
+    ck_assert_int_eq(status, NULL_PARAM);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+
+    test_ser = NULL;
+    ser_open_view(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+    ser_append_frame_async(test_ser, state.buffers[0], 0, append_done, &state, &status);
+    ck_assert_int_eq(status, WRITE_ON_READONLY);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+START_TEST(async_append_sticky_error) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* without a callback the failure waits for the next synchronous call */
+    uint8_t image_data[ASYNC_APPEND_FRAME_SIZE] = {0};
+    ser_append_frame_async(test_ser, image_data, 0, NULL, NULL, &status);
+    ser_append_frame_async(test_ser, image_data, 0, NULL, NULL, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_flush(test_ser, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_SIZE);
+
+    /* reporting it clears it */
+    status = 0;
+    ser_flush(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_append_frame_async(test_ser, image_data, 0, NULL, NULL, &status);
+    ser_append_frame(test_ser, image_data, 0, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_SIZE);
+
+    status = 0;
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ser_append_frame(test_ser, image_data, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the close routines report it as well */
+    test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ser_append_frame_async(test_ser, image_data, 0, NULL, NULL, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_SIZE);
+} END_TEST
+
+Suite* async_append_suite() {
+    Suite* s;
+    s = suite_create("Async Append");
+
+    TCase* tc_async_append = tcase_create("async_append");
+    tcase_add_test(tc_async_append, async_append_file);
+    tcase_add_test(tc_async_append, async_append_mixed);
+    tcase_add_test(tc_async_append, async_append_queue_full);
+    tcase_add_test(tc_async_append, async_append_from_done);
+    tcase_add_test(tc_async_append, async_append_errors);
+    tcase_add_test(tc_async_append, async_append_sticky_error);
+    suite_add_tcase(s, tc_async_append);
+
+    return s;
+}
+
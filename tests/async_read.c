@@ -0,0 +1,237 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static SERTest3x50Structure async_data;
+
+void async_read_setup() {
+    int status = 0;
+    async_data = test_data_3x50;
+    for (size_t i = 0; i < 3; i++) {
+        memset(async_data.data + i * 50 * 50, (int)(i + 1), 50 * 50);
+    }
+    ser_open_view(
+            &test_ser_3x50,
+            (uint8_t*)&async_data,
+            sizeof(async_data),
+            READONLY,
+            &status
+    );
+}
+
+void async_read_teardown() {
+    int status = 0;
+    ser_close_memory(test_ser_3x50, &status);
+    test_ser_3x50 = NULL;
+}
+
+START_TEST(async_read_success) {
+    int status = 0;
+    serasync* async = NULL;
+    ser_async_create(&async, test_ser_3x50, 4, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static uint8_t buffers[3][50 * 50];
+    for (size_t i = 0; i < 3; i++) {
+        ser_async_submit(async, buffers[i], i, &buffers[i], &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    size_t collected = 0;
+    bool seen[3] = {false, false, false};
+    while (collected < 3) {
+        sercompletion completions[3];
+        size_t count = 0;
+        ser_async_wait(async, completions, 3, &count, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_gt(count, 0);
+
+        for (size_t i = 0; i < count; i++) {
+            size_t idx = completions[i].idx;
+            ck_assert_int_eq(completions[i].status, NO_ERROR);
+            ck_assert_ptr_eq(completions[i].dest, buffers[idx]);
+            ck_assert_ptr_eq(completions[i].user_data, &buffers[idx]);
+            ck_assert_mem_eq(buffers[idx], async_data.data + idx * 50 * 50, 50 * 50);
+            seen[idx] = true;
+        }
+        collected += count;
+    }
+    ck_assert(seen[0] && seen[1] && seen[2]);
+
+    /* nothing in flight, wait returns immediately */
+    sercompletion completion;
+    size_t count = 1;
+    ser_async_wait(async, &completion, 1, &count, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(count, 0);
+
+    ser_async_destroy(async, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(async_read_queue_full) {
+    int status = 0;
+    serasync* async = NULL;
+    ser_async_create(&async, test_ser_3x50, 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static uint8_t buffer[50 * 50];
+    ser_async_submit(async, buffer, 0, NULL, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_async_submit(async, buffer, 1, NULL, &status);
+    ck_assert_int_eq(status, ASYNC_QUEUE_FULL);
+
+    /* uncollected completions are discarded */
+    status = 0;
+    ser_async_destroy(async, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(async_read_oob_idx) {
+    int status = 0;
+    serasync* async = NULL;
+    ser_async_create(&async, test_ser_3x50, 2, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static uint8_t buffer[50 * 50];
+    ser_async_submit(async, buffer, 3, NULL, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_IDX);
+
+    status = 0;
+    sercompletion completion;
+    size_t count = 1;
+    ser_async_poll(async, &completion, 1, &count, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(count, 0);
+
+    ser_async_destroy(async, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(async_read_invalid_depth) {
+    int status = 0;
+    serasync* async = NULL;
+    ser_async_create(&async, test_ser_3x50, 0, &status);
+    ck_assert_int_eq(status, INVALID_ASYNC_DEPTH);
+    ck_assert_ptr_null(async);
+} END_TEST
+
+#define ASYNC_DEEP_FRAMES       256
+#define ASYNC_DEEP_DEPTH        128
+#define ASYNC_DEEP_FRAME_SIZE   (32 * 32)
+
+/* frame i is filled with i + 1 */
+static void create_deep_ser(char* filepath, char* dir) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_file(&test_ser, filepath, &status);
+    ser_write_image_width(test_ser, 32, &status);
+    ser_write_image_height(test_ser, 32, &status);
+
+    uint8_t image_data[ASYNC_DEEP_FRAME_SIZE];
+    for (int i = 0; i < ASYNC_DEEP_FRAMES; i++) {
+        memset(image_data, i + 1, sizeof(image_data));
+        ser_append_frame(test_ser, image_data, 0, &status);
+    }
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+}
+
+/* keeps the queue full until every frame has been read back */
+static void read_deep(serfile* test_ser) {
+    int status = 0;
+    serasync* async = NULL;
+    ser_async_create(&async, test_ser, ASYNC_DEEP_DEPTH, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static uint8_t buffers[ASYNC_DEEP_DEPTH][ASYNC_DEEP_FRAME_SIZE];
+    size_t next = 0;
+    for (; next < ASYNC_DEEP_DEPTH; next++) {
+        ser_async_submit(async, buffers[next], next, buffers[next], &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    size_t collected = 0;
+    while (collected < ASYNC_DEEP_FRAMES) {
+        sercompletion completions[32];
+        size_t count = 0;
+        ser_async_wait(async, completions, 32, &count, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_gt(count, 0);
+
+        for (size_t i = 0; i < count; i++) {
+            uint8_t* buffer = (uint8_t*)completions[i].dest;
+            ck_assert_int_eq(completions[i].status, NO_ERROR);
+            ck_assert_int_eq(buffer[0], (uint8_t)(completions[i].idx + 1));
+            ck_assert_int_eq(buffer[ASYNC_DEEP_FRAME_SIZE - 1], (uint8_t)(completions[i].idx + 1));
+
+            if (next < ASYNC_DEEP_FRAMES) {
+                ser_async_submit(async, buffer, next++, buffer, &status);
+                ck_assert_int_eq(status, NO_ERROR);
+            }
+        }
+        collected += count;
+    }
+
+    ser_async_destroy(async, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+}
+
+START_TEST(async_read_deep_queue) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_deep_ser(filepath, dir);
+    /* <- Setup */
+
+    int (*opener[])(serfile**, const char*, int, int*) = {
+        ser_open_file,
+        ser_open_file_positional
+    };
+    for (int i = 0; i < 2; i++) {
+        int status = 0;
+        serfile* test_ser = NULL;
+        opener[i](&test_ser, filepath, READONLY, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+
+        read_deep(test_ser);
+
+        ser_close_file(test_ser, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    /* Teardown -> */
+    unlink(filepath);
+    rmdir(dir);
+} END_TEST
+
+Suite* async_read_suite() {
+    Suite* s;
+    s = suite_create("Async Read");
+
+    TCase* tc_async_read;
+    tc_async_read = tcase_create("async_read");
+    tcase_add_checked_fixture(tc_async_read, async_read_setup, async_read_teardown);
+    tcase_add_test(tc_async_read, async_read_success);
+    tcase_add_test(tc_async_read, async_read_queue_full);
+    tcase_add_test(tc_async_read, async_read_oob_idx);
+    tcase_add_test(tc_async_read, async_read_invalid_depth);
+    suite_add_tcase(s, tc_async_read);
+
+    TCase* tc_async_deep = tcase_create("async_read_deep");
+    tcase_add_test(tc_async_deep, async_read_deep_queue);
+    suite_add_tcase(s, tc_async_deep);
+
+    return s;
+}
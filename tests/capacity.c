@@ -0,0 +1,205 @@
+#include "suites.h"
+
+#include <check.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static serfile* create_capture(int32_t width, int32_t height, bool trailer) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ser_write_image_width(test_ser, width, &status);
+    ser_write_image_height(test_ser, height, &status);
+    if (trailer) {
+        ser_write_date_time(test_ser, TEST_TIMESTAMP_VALUE, &status);
+    }
+    ck_assert_int_eq(status, NO_ERROR);
+    return test_ser;
+}
+
+START_TEST(capacity_grows_geometrically) {
+    int status = 0;
+    serfile* test_ser = create_capture(2, 2, true);
+
+    size_t capacity = 0;
+    size_t growths = 0;
+    uint8_t image_data[2 * 2] = {0};
+    for (int64_t i = 0; i < 2000; i++) {
+        ser_append_frame(test_ser, image_data, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+
+        size_t new_capacity = 0;
+        ser_get_capacity(test_ser, &new_capacity, &status);
+        ck_assert_int_ge(new_capacity, i + 1);
+        if (new_capacity != capacity) {
+            growths++;
+            capacity = new_capacity;
+        }
+    }
+    ck_assert_int_lt(growths, 40);
+
+    for (int64_t i = 0; i < 2000; i += 499) {
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(timestamp, i);
+    }
+
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(capacity_reserve) {
+    int status = 0;
+    serfile* test_ser = create_capture(50, 50, true);
+
+    ser_reserve_frames(test_ser, 100, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    size_t capacity = 0;
+    ser_get_capacity(test_ser, &capacity, &status);
+    ck_assert_int_eq(capacity, 100);
+
+    uint8_t image_data[50 * 50];
+    memset(image_data, 0xA0, sizeof(image_data));
+    ser_append_frame(test_ser, image_data, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    const void* first = NULL;
+    ser_get_frame_ptr(test_ser, 0, &first, &status);
+
+    for (int i = 1; i < 100; i++) {
+        ser_append_frame(test_ser, image_data, 0, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    const void* again = NULL;
+    ser_get_frame_ptr(test_ser, 0, &again, &status);
+    ck_assert_ptr_eq(first, again);
+
+    ser_get_capacity(test_ser, &capacity, &status);
+    ck_assert_int_eq(capacity, 100);
+
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(capacity_shrink_to_fit) {
+    int status = 0;
+    serfile* test_ser = create_capture(50, 50, true);
+
+    ser_reserve_frames(test_ser, 100, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50] = {0};
+    for (int i = 0; i < 10; i++) {
+        ser_append_frame(test_ser, image_data, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    ser_shrink_to_fit(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    size_t capacity = 0;
+    ser_get_capacity(test_ser, &capacity, &status);
+    ck_assert_int_eq(capacity, 10);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 9, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, 9);
+
+    /* growth resumes after shrinking */
+    ser_append_frame(test_ser, image_data, 10, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ser_get_capacity(test_ser, &capacity, &status);
+    ck_assert_int_ge(capacity, 11);
+
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(capacity_open_memory) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_memory(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READWRITE,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    size_t capacity = 0;
+    ser_get_capacity(test_ser, &capacity, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(capacity, 3);
+
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(capacity_reserve_readonly) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_reserve_frames(test_ser, 100, &status);
+    ck_assert_int_eq(status, WRITE_ON_READONLY);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+START_TEST(capacity_reserve_invalid_frame_size) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_reserve_frames(test_ser, 100, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_SIZE);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+START_TEST(capacity_null_param) {
+    int status = 0;
+    serfile* test_ser = create_capture(2, 2, false);
+
+    ser_get_capacity(test_ser, NULL, &status);
+    ck_assert_int_eq(status, NULL_PARAM);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+Suite* capacity_suite() {
+    Suite* s;
+    s = suite_create("Capacity");
+
+    TCase* tc_capacity = tcase_create("capacity");
+    tcase_add_test(tc_capacity, capacity_grows_geometrically);
+    tcase_add_test(tc_capacity, capacity_reserve);
+    tcase_add_test(tc_capacity, capacity_shrink_to_fit);
+    tcase_add_test(tc_capacity, capacity_open_memory);
+    tcase_add_test(tc_capacity, capacity_reserve_readonly);
+    tcase_add_test(tc_capacity, capacity_reserve_invalid_frame_size);
+    tcase_add_test(tc_capacity, capacity_null_param);
+    suite_add_tcase(s, tc_capacity);
+
+    return s;
+}
+
@@ -0,0 +1,223 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static serfile* create_capture_ser(void) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ser_write_date_time(test_ser, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    return test_ser;
+}
+
+/* a backend whose frame writes wait until the gate opens */
+typedef struct {
+    uint8_t data[HDR_SIZE + 2 * 50 * 50 + 2 * sizeof(int64_t)];
+    size_t size;
+    int open;
+} gated_store;
+
+static size_t gated_read(void* context, void* buffer, size_t size, uint64_t offset) {
+    gated_store* store = (gated_store*)context;
+    if (offset + size > store->size) {
+        return 0;
+    }
+    memcpy(buffer, store->data + offset, size);
+    return size;
+}
+
+static size_t gated_write(void* context, const void* data, size_t size, uint64_t offset) {
+    gated_store* store = (gated_store*)context;
+    while (offset >= HDR_SIZE && !__atomic_load_n(&store->open, __ATOMIC_ACQUIRE)) {
+        usleep(1000);
+    }
+    if (offset + size > sizeof(store->data)) {
+        return 0;
+    }
+    memcpy(store->data + offset, data, size);
+    if (offset + size > store->size) {
+        store->size = offset + size;
+    }
+    return size;
+}
+
+static uint64_t gated_size(void* context) {
+    return ((gated_store*)context)->size;
+}
+
+START_TEST(capture_push_frames) {
+    int status = 0;
+    serfile* test_ser = create_capture_ser();
+
+    sercapture* capture = NULL;
+    ser_capture_create(&capture, test_ser, 8, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50];
+    for (int i = 0; i < 100; i++) {
+        memset(image_data, i, sizeof(image_data));
+        do {
+            status = 0;
+            ser_capture_push(capture, image_data, TEST_TIMESTAMP_VALUE + i, &status);
+            if (status == ASYNC_QUEUE_FULL) {
+                usleep(100);
+            }
+        } while (status == ASYNC_QUEUE_FULL);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    ser_capture_destroy(capture, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 100);
+
+    /* frames and timestamps land in push order */
+    uint8_t buffer[50 * 50];
+    for (int i = 0; i < 100; i++) {
+        ser_read_frame(test_ser, buffer, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(buffer[0], i);
+        ck_assert_int_eq(buffer[sizeof(buffer) - 1], i);
+
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, i, &status);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + i);
+    }
+
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(capture_stats_dropped) {
+    static gated_store store;
+    memset(&store, 0, sizeof(store));
+    serbackend backend = {
+        .context = &store,
+        .reader = gated_read,
+        .writer = gated_write,
+        .sizer = gated_size,
+        .flusher = NULL,
+        .closer = NULL,
+        .lender = NULL
+    };
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_custom(&test_ser, &backend, &status);
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    sercapture* capture = NULL;
+    ser_capture_create(&capture, test_ser, 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the writer holds the only slot until the gate opens */
+    uint8_t image_data[50 * 50] = {0};
+    ser_capture_push(capture, image_data, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_capture_push(capture, image_data, 0, &status);
+    ck_assert_int_eq(status, ASYNC_QUEUE_FULL);
+
+    status = 0;
+    sercapturestats stats;
+    ser_capture_stats(capture, &stats, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(stats.depth, 1);
+    ck_assert_int_eq(stats.high_water, 1);
+    ck_assert_int_eq(stats.written, 0);
+    ck_assert_int_eq(stats.dropped, 1);
+
+    __atomic_store_n(&store.open, 1, __ATOMIC_RELEASE);
+    while (stats.written == 0) {
+        usleep(1000);
+        ser_capture_stats(capture, &stats, &status);
+    }
+    ck_assert_int_eq(stats.depth, 0);
+
+    ser_capture_push(capture, image_data, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_capture_destroy(capture, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 2);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(capture_invalid_args) {
+    int status = 0;
+    serfile* test_ser = create_capture_ser();
+
+    sercapture* capture = NULL;
+    ser_capture_create(&capture, test_ser, 0, &status);
+    ck_assert_int_eq(status, INVALID_ASYNC_DEPTH);
+    ck_assert_ptr_null(capture);
+
+    status = 0;
+    ser_capture_create(NULL, test_ser, 4, &status);
+    ck_assert_int_eq(status, NULL_PARAM);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+
+    /* frame geometry must be known */
+    test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ser_capture_create(&capture, test_ser, 4, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_SIZE);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+START_TEST(capture_readonly) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    sercapture* capture = NULL;
+    ser_capture_create(&capture, test_ser, 4, &status);
+    ck_assert_int_eq(status, WRITE_ON_READONLY);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+Suite* capture_suite() {
+    Suite* s;
+    s = suite_create("Capture");
+
+    TCase* tc_capture = tcase_create("capture");
+    tcase_add_test(tc_capture, capture_push_frames);
+    tcase_add_test(tc_capture, capture_stats_dropped);
+    tcase_add_test(tc_capture, capture_invalid_args);
+    tcase_add_test(tc_capture, capture_readonly);
+    suite_add_tcase(s, tc_capture);
+
+    return s;
+}
+
@@ -0,0 +1,223 @@
+#include "suites.h"
+
+#include <check.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+/* frame i is filled with i + 1, timestamp i is TEST_TIMESTAMP_VALUE + i */
+static void create_clone_ser(char* filepath, char* dir) {
+    SERTest3x50Structure test_data = test_data_3x50;
+    for (int i = 0; i < 3; i++) {
+        memset(test_data.data + i * 50 * 50, i + 1, 50 * 50);
+        test_data.trlr[i] = TEST_TIMESTAMP_VALUE + i;
+    }
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data));
+}
+
+static void* clone_reader(void* arg) {
+    serfile* test_ser = (serfile*)arg;
+    int status = 0;
+    uint8_t buffer[50 * 50];
+    for (int pass = 0; pass < 200 && !status; pass++) {
+        size_t idx = pass % 3;
+        ser_read_frame(test_ser, buffer, idx, &status);
+        if (buffer[0] != idx + 1 || buffer[sizeof(buffer) - 1] != idx + 1) {
+            status = READ_ERROR;
+        }
+
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, idx, &status);
+        if (timestamp != (int64_t)(TEST_TIMESTAMP_VALUE + idx)) {
+            status = READ_ERROR;
+        }
+    }
+    return (void*)(intptr_t)status;
+}
+
+START_TEST(clone_handle_success) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_clone_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    serfile* clone_ser = NULL;
+    ser_clone_handle(test_ser, &clone_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_ptr_nonnull(clone_ser);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(clone_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 3);
+
+    /* the clone outlives the handle it was made from */
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ck_assert_int_eq((intptr_t)clone_reader(clone_ser), NO_ERROR);
+
+    ser_close_file(clone_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(clone_handle_threads) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_clone_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    serfile* clones[4] = {NULL};
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        ser_clone_handle(test_ser, &clones[i], &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+    for (int i = 0; i < 4; i++) {
+        ck_assert_int_eq(pthread_create(&threads[i], NULL, clone_reader, clones[i]), 0);
+    }
+    for (int i = 0; i < 4; i++) {
+        void* result = NULL;
+        pthread_join(threads[i], &result);
+        ck_assert_int_eq((intptr_t)result, NO_ERROR);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        ser_close_file(clones[i], &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(clone_handle_readwrite) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_clone_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    serfile* clone_ser = NULL;
+    ser_clone_handle(test_ser, &clone_ser, &status);
+    ck_assert_int_eq(status, NOT_SUPPORTED);
+    ck_assert_ptr_null(clone_ser);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(clone_handle_memory) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    serfile* clone_ser = NULL;
+    ser_clone_handle(test_ser, &clone_ser, &status);
+    ck_assert_int_eq(status, NOT_SUPPORTED);
+    ck_assert_ptr_null(clone_ser);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+START_TEST(clone_handle_occupied) {
+    int status = 0;
+    serfile* clone_ser = (serfile*)&status;
+    ser_clone_handle(NULL, &clone_ser, &status);
+    ck_assert_int_eq(status, NULL_SPTR);
+
+    status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+    ser_clone_handle(test_ser, &clone_ser, &status);
+    ck_assert_int_eq(status, SPTR_OCCUPIED);
+
+    status = 0;
+    ser_clone_handle(test_ser, NULL, &status);
+    ck_assert_int_eq(status, NULL_SPTRPTR);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+Suite* clone_suite() {
+    Suite* s;
+    s = suite_create("Clone");
+
+    TCase* tc_clone = tcase_create("clone_handle");
+    tcase_add_test(tc_clone, clone_handle_success);
+    tcase_add_test(tc_clone, clone_handle_threads);
+    tcase_add_test(tc_clone, clone_handle_readwrite);
+    tcase_add_test(tc_clone, clone_handle_memory);
+    tcase_add_test(tc_clone, clone_handle_occupied);
+    suite_add_tcase(s, tc_clone);
+
+    return s;
+}
+
@@ -0,0 +1,237 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+/* frame count as currently stored in the file header */
+static int32_t stored_frame_count(const char* filepath) {
+    int32_t frame_count = -1;
+    FILE* file = fopen(filepath, "rb");
+    if (!file) {
+        ck_abort_msg("Failed to open test file");
+    }
+    fseek(file, FRAMECOUNT_KEY, SEEK_SET);
+    if (fread(&frame_count, 1, FRAMECOUNT_LEN, file) != FRAMECOUNT_LEN) {
+        ck_abort_msg("Failed to read frame count");
+    }
+    fclose(file);
+    return frame_count;
+}
+
+START_TEST(commit_every_frame_default) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50] = {0};
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(stored_frame_count(filepath), 4);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(commit_frames) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_set_commit_policy(test_ser, COMMIT_FRAMES, 2, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50] = {0};
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(stored_frame_count(filepath), 3);
+
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(stored_frame_count(filepath), 5);
+
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(stored_frame_count(filepath), 5);
+
+    /* close commits the pending frame */
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(stored_frame_count(filepath), 6);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(commit_on_flush) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_set_commit_policy(test_ser, COMMIT_ON_FLUSH, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50] = {0};
+    for (int i = 0; i < 4; i++) {
+        ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+    ck_assert_int_eq(stored_frame_count(filepath), 3);
+
+    ser_flush(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(stored_frame_count(filepath), 7);
+
+    /* the file is a valid SER at the flush point */
+    serfile* check_ser = NULL;
+    ser_open_file(&check_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(check_ser, &timestamp, 6, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE);
+
+    ser_close_file(check_ser, &status);
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(commit_interval) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_set_commit_policy(test_ser, COMMIT_INTERVAL, 50, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50] = {0};
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(stored_frame_count(filepath), 3);
+
+    usleep(60 * 1000);
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(stored_frame_count(filepath), 5);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(commit_invalid_policy) {
+    int status = 0;
+    ser_set_commit_policy(test_ser_3x50, 42, 0, &status);
+    ck_assert_int_eq(status, INVALID_SET_VALUE);
+
+    status = 0;
+    ser_set_commit_policy(test_ser_3x50, COMMIT_FRAMES, 0, &status);
+    ck_assert_int_eq(status, INVALID_SET_VALUE);
+} END_TEST
+
+START_TEST(flush_readonly) {
+    int status = 0;
+    ser_flush(test_ser_3x50, &status);
+    ck_assert_int_eq(status, WRITE_ON_READONLY);
+} END_TEST
+
+static void commit_setup() {
+    int status = 0;
+    ser_open_view(
+            &test_ser_3x50,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+}
+
+static void commit_teardown() {
+    int status = 0;
+    ser_close_memory(test_ser_3x50, &status);
+    test_ser_3x50 = NULL;
+}
+
+Suite* commit_suite() {
+    Suite* s;
+    s = suite_create("Commit");
+
+    TCase* tc_commit_policy = tcase_create("commit_policy");
+    tcase_add_test(tc_commit_policy, commit_every_frame_default);
+    tcase_add_test(tc_commit_policy, commit_frames);
+    tcase_add_test(tc_commit_policy, commit_on_flush);
+    tcase_add_test(tc_commit_policy, commit_interval);
+    suite_add_tcase(s, tc_commit_policy);
+
+    TCase* tc_commit_args = tcase_create("commit_args");
+    tcase_add_checked_fixture(tc_commit_args, commit_setup, commit_teardown);
+    tcase_add_test(tc_commit_args, commit_invalid_policy);
+    tcase_add_test(tc_commit_args, flush_readonly);
+    suite_add_tcase(s, tc_commit_args);
+
+    return s;
+}
+
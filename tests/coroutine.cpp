@@ -0,0 +1,266 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "../cserio.hpp"
+
+
+/* ser_test_data.h initializes its char arrays the C way, C++ rejects it */
+#define TEST_TIMESTAMP_VALUE    0x08d126583cd43bb0
+
+#define COROUTINE_FRAMES        64
+#define COROUTINE_FRAME_SIZE    (50 * 50)
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+static void create_empty_ser(char* filepath, char* dir) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_file(&test_ser, filepath, &status);
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ser_write_date_time(test_ser, TEST_TIMESTAMP_VALUE, &status);
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+}
+
+/* frame i is filled with i + 1, timestamp i is TEST_TIMESTAMP_VALUE + i */
+static void create_coroutine_ser(char* filepath, char* dir) {
+    create_empty_ser(filepath, dir);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READWRITE, &status);
+
+    uint8_t image_data[COROUTINE_FRAME_SIZE];
+    for (int i = 0; i < COROUTINE_FRAMES; i++) {
+        memset(image_data, i + 1, sizeof(image_data));
+        ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE + i, &status);
+    }
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+}
+
+static cserio::task read_into(cserio::engine& engine, uint8_t* dest, size_t idx, int* result) {
+    *result = co_await engine.read_frame(dest, idx);
+}
+
+START_TEST(coroutine_read_frames) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_coroutine_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* far more reads in flight than the engine hands to the library */
+    const size_t reads = 4 * COROUTINE_FRAMES;
+    uint8_t* frames = (uint8_t*)malloc(reads * COROUTINE_FRAME_SIZE);
+    int results[reads];
+    {
+        cserio::engine engine(test_ser, 8, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+
+        for (size_t i = 0; i < reads; i++) {
+            results[i] = -1;
+            read_into(engine, frames + i * COROUTINE_FRAME_SIZE, i % COROUTINE_FRAMES, &results[i]);
+        }
+        ck_assert_uint_eq(engine.outstanding(), reads);
+
+        ck_assert_int_eq(engine.run(), NO_ERROR);
+        ck_assert_uint_eq(engine.outstanding(), 0);
+    }
+
+    for (size_t i = 0; i < reads; i++) {
+        ck_assert_int_eq(results[i], NO_ERROR);
+        const uint8_t* frame = frames + i * COROUTINE_FRAME_SIZE;
+        ck_assert_int_eq(frame[0], i % COROUTINE_FRAMES + 1);
+        ck_assert_int_eq(frame[COROUTINE_FRAME_SIZE - 1], i % COROUTINE_FRAMES + 1);
+    }
+    free(frames);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+static cserio::task append_from(cserio::engine& engine, const uint8_t* data, uint64_t timestamp, int* result) {
+    *result = co_await engine.append_frame(data, timestamp);
+}
+
+START_TEST(coroutine_append_frames) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_empty_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t* frames = (uint8_t*)malloc(COROUTINE_FRAMES * COROUTINE_FRAME_SIZE);
+    int results[COROUTINE_FRAMES];
+    {
+        cserio::engine engine(test_ser, 4, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+
+        /* appended in the order they are awaited */
+        for (int i = 0; i < COROUTINE_FRAMES; i++) {
+            uint8_t* frame = frames + i * COROUTINE_FRAME_SIZE;
+            memset(frame, i + 1, COROUTINE_FRAME_SIZE);
+            results[i] = -1;
+            append_from(engine, frame, TEST_TIMESTAMP_VALUE + i, &results[i]);
+        }
+
+        while (engine.outstanding()) {
+            engine.poll();
+        }
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    free(frames);
+
+    test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t buffer[COROUTINE_FRAME_SIZE];
+    for (int i = 0; i < COROUTINE_FRAMES; i++) {
+        ck_assert_int_eq(results[i], NO_ERROR);
+
+        ser_read_frame(test_ser, buffer, i, &status);
+        ck_assert_int_eq(buffer[0], i + 1);
+
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, i, &status);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + i);
+    }
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+static cserio::task append_then_read(cserio::engine& engine, int* result) {
+    uint8_t frame[COROUTINE_FRAME_SIZE];
+    for (int i = 0; i < 3 && !*result; i++) {
+        memset(frame, 0xA0 + i, sizeof(frame));
+        *result = co_await engine.append_frame(frame, TEST_TIMESTAMP_VALUE + i);
+    }
+
+    /* the reads wait for the appends before them */
+    for (int i = 0; i < 3 && !*result; i++) {
+        *result = co_await engine.read_frame(frame, i);
+        if (!*result && (frame[0] != 0xA0 + i || frame[sizeof(frame) - 1] != 0xA0 + i)) {
+            *result = READ_ERROR;
+        }
+    }
+}
+
+START_TEST(coroutine_append_then_read) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_empty_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int result = 0;
+    {
+        cserio::engine engine(test_ser, 2, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+
+        append_then_read(engine, &result);
+        ck_assert_int_eq(engine.run(), NO_ERROR);
+    }
+    ck_assert_int_eq(result, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(coroutine_errors) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_coroutine_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t frame[COROUTINE_FRAME_SIZE] = {0};
+    int results[3] = {-1, -1, -1};
+    {
+        cserio::engine engine(test_ser, 4, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+
+        read_into(engine, frame, COROUTINE_FRAMES, &results[0]);
+        append_from(engine, frame, 0, &results[1]);
+        read_into(engine, frame, 2, &results[2]);
+        ck_assert_int_eq(engine.run(), NO_ERROR);
+    }
+    ck_assert_int_eq(results[0], INVALID_FRAME_IDX);
+    ck_assert_int_eq(results[1], WRITE_ON_READONLY);
+    ck_assert_int_eq(results[2], NO_ERROR);
+    ck_assert_int_eq(frame[0], 3);
+
+    /* an engine that failed to start fails every operation */
+    {
+        cserio::engine engine(test_ser, 0, &status);
+        ck_assert_int_eq(status, INVALID_ASYNC_DEPTH);
+
+        read_into(engine, frame, 0, &results[0]);
+        ck_assert_int_eq(engine.poll(), 1);
+        ck_assert_int_eq(results[0], INVALID_ASYNC_DEPTH);
+    }
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+Suite* coroutine_suite() {
+    Suite* s;
+    s = suite_create("Coroutine");
+
+    TCase* tc_coroutine = tcase_create("coroutine");
+    tcase_add_test(tc_coroutine, coroutine_read_frames);
+    tcase_add_test(tc_coroutine, coroutine_append_frames);
+    tcase_add_test(tc_coroutine, coroutine_append_then_read);
+    tcase_add_test(tc_coroutine, coroutine_errors);
+    suite_add_tcase(s, tc_coroutine);
+
+    return s;
+}
+
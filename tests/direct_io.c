@@ -0,0 +1,373 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+START_TEST(create_direct_append_frames) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/cserio_test_file.ser", dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_file_direct(&test_ser, filepath, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ser_write_date_time(test_ser, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50];
+    for (int i = 0; i < 3; i++) {
+        memset(image_data, 0xA0 + i, sizeof(image_data));
+        ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE + i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    struct stat st;
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, HDR_SIZE + 3 * sizeof(image_data) + 3 * sizeof(int64_t));
+
+    test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t buffer[50 * 50];
+    for (int i = 0; i < 3; i++) {
+        memset(image_data, 0xA0 + i, sizeof(image_data));
+        ser_read_frame(test_ser, buffer, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_mem_eq(buffer, image_data, sizeof(image_data));
+
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + i);
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(create_direct_exists) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_file_direct(&test_ser, filepath, &status);
+    ck_assert_int_eq(status, FILE_EXISTS);
+    ck_assert_ptr_null(test_ser);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(create_direct_append_buffer) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+
+    char filepath[512];
+    snprintf(filepath, sizeof(filepath), "%s/cserio_test_file.ser", dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_file_direct(&test_ser, filepath, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* 2 MB frames, so the staging buffer is spilled several times */
+    ser_write_image_width(test_ser, 1000, &status);
+    ser_write_image_height(test_ser, 1000, &status);
+    ser_write_pixel_depth_per_plane(test_ser, 16, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    size_t frame_byte_size = 1000 * 1000 * 2;
+    for (int i = 0; i < 10; i++) {
+        void* buffer = NULL;
+        ser_get_append_buffer(test_ser, &buffer, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_ptr_nonnull(buffer);
+
+        memset(buffer, i + 1, frame_byte_size);
+        ser_append_frame(test_ser, buffer, 0, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    /* frames read back through the direct handle, staged or not */
+    uint8_t* frame = (uint8_t*)malloc(frame_byte_size);
+    for (int i = 0; i < 10; i++) {
+        ser_read_frame(test_ser, frame, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(frame[0], i + 1);
+        ck_assert_int_eq(frame[frame_byte_size - 1], i + 1);
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    struct stat st;
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, HDR_SIZE + 10 * frame_byte_size);
+
+    test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 10);
+
+    ser_read_frame(test_ser, frame, 9, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(frame[0], 10);
+    ck_assert_int_eq(frame[frame_byte_size - 1], 10);
+
+    free(frame);
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_direct_append_frame) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    size_t init_file_size = sizeof(test_data_3x50);
+    create_temp_ser(filepath, dir, &test_data_3x50, init_file_size);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_direct(&test_ser, filepath, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50];
+    memset(image_data, 0xA0, sizeof(image_data));
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    struct stat st;
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, init_file_size + sizeof(image_data) + sizeof(int64_t));
+
+    test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t buffer[50 * 50];
+    ser_read_frame(test_ser, buffer, 3, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(buffer, image_data, sizeof(image_data));
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 3, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_direct_append_buffer) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_direct(&test_ser, filepath, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the buffer lies over the trailer on disk */
+    void* buffer = NULL;
+    ser_get_append_buffer(test_ser, &buffer, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    memset(buffer, 0xAB, 50 * 50);
+    ser_append_frame(test_ser, buffer, TEST_TIMESTAMP_VALUE + 3, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    for (int i = 0; i < 3; i++) {
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, i, &status);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE);
+    }
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 3, &status);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + 3);
+
+    uint8_t frame[50 * 50];
+    ser_read_frame(test_ser, frame, 3, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(frame[0], 0xAB);
+    ck_assert_int_eq(frame[sizeof(frame) - 1], 0xAB);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+#define LARGE_TRAILER_FRAMES    1200000
+
+START_TEST(open_direct_large_trailer) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+
+    /* 1x1 frames, so the trailer is larger than the stage */
+    size_t data_size = LARGE_TRAILER_FRAMES;
+    size_t trailer_size = LARGE_TRAILER_FRAMES * sizeof(int64_t);
+    uint8_t* file_data = (uint8_t*)malloc(HDR_SIZE + data_size + trailer_size);
+    SERHdrStructure hdr = test_data_3x50.hdr;
+    hdr.image_width = 1;
+    hdr.image_height = 1;
+    hdr.frame_count = LARGE_TRAILER_FRAMES;
+    memcpy(file_data, &hdr, HDR_SIZE);
+    for (size_t i = 0; i < LARGE_TRAILER_FRAMES; i++) {
+        file_data[HDR_SIZE + i] = (uint8_t)i;
+        int64_t timestamp = TEST_TIMESTAMP_VALUE + i;
+        memcpy(file_data + HDR_SIZE + data_size + i * sizeof(int64_t), &timestamp, sizeof(int64_t));
+    }
+    create_temp_ser(filepath, dir, file_data, HDR_SIZE + data_size + trailer_size);
+    free(file_data);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_direct(&test_ser, filepath, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t pixel = 0xAB;
+    ser_append_frame(test_ser, &pixel, TEST_TIMESTAMP_VALUE + LARGE_TRAILER_FRAMES, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    size_t checked[] = {0, 1000000, LARGE_TRAILER_FRAMES - 1, LARGE_TRAILER_FRAMES};
+    for (size_t i = 0; i < sizeof(checked) / sizeof(checked[0]); i++) {
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, checked[i], &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + checked[i]);
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(append_buffer_not_supported) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    void* buffer = NULL;
+    ser_get_append_buffer(test_ser, &buffer, &status);
+    ck_assert_int_eq(status, NOT_SUPPORTED);
+    ck_assert_ptr_null(buffer);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+Suite* direct_io_suite() {
+    Suite* s;
+    s = suite_create("Direct IO");
+
+    TCase* tc_create_direct = tcase_create("create_direct");
+    tcase_add_test(tc_create_direct, create_direct_append_frames);
+    tcase_add_test(tc_create_direct, create_direct_exists);
+    tcase_add_test(tc_create_direct, create_direct_append_buffer);
+    suite_add_tcase(s, tc_create_direct);
+
+    TCase* tc_open_direct = tcase_create("open_direct");
+    tcase_add_test(tc_open_direct, open_direct_append_frame);
+    tcase_add_test(tc_open_direct, open_direct_append_buffer);
+    tcase_add_test(tc_open_direct, open_direct_large_trailer);
+    tcase_add_test(tc_open_direct, append_buffer_not_supported);
+    suite_add_tcase(s, tc_open_direct);
+
+    return s;
+}
+
@@ -0,0 +1,274 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+typedef int (*open_fn)(serfile**, const char*, int, int*);
+
+static void append_frames(serfile* writer, int first, int count) {
+    int status = 0;
+    uint8_t image_data[50 * 50];
+    for (int i = first; i < first + count; i++) {
+        memset(image_data, i + 1, sizeof(image_data));
+        ser_append_frame(writer, image_data, TEST_TIMESTAMP_VALUE + i, &status);
+    }
+    ck_assert_int_eq(status, NO_ERROR);
+}
+
+static void check_follow(serfile* reader, int frames, bool timestamps) {
+    int status = 0;
+    int32_t frame_count = 0;
+    ser_read_frame_count(reader, &frame_count, &status);
+    ck_assert_int_eq(frame_count, frames);
+
+    uint8_t buffer[50 * 50];
+    for (int i = 0; i < frames; i++) {
+        ser_read_frame(reader, buffer, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(buffer[0], i + 1);
+        ck_assert_int_eq(buffer[sizeof(buffer) - 1], i + 1);
+    }
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(reader, &timestamp, frames - 1, &status);
+    if (timestamps) {
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + frames - 1);
+    } else {
+        ck_assert_int_eq(status, INVALID_TRAILER_IDX);
+    }
+}
+
+/* the writer uses positional IO so every write is visible at once */
+static void follow_writer(open_fn open_reader) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    char filepath[512];
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    int status = 0;
+    serfile* writer = NULL;
+    ser_create_file(&writer, filepath, &status);
+    ser_close_file(writer, &status);
+    writer = NULL;
+    ser_open_file_positional(&writer, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    /* <- Setup */
+
+    /* a freshly created SER has no geometry yet */
+    serfile* reader = NULL;
+    open_reader(&reader, filepath, READFOLLOW, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_write_image_width(writer, 50, &status);
+    ser_write_image_height(writer, 50, &status);
+    ser_write_date_time(writer, TEST_TIMESTAMP_VALUE, &status);
+    append_frames(writer, 0, 3);
+    ser_flush(writer, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the trailer is only trusted once a second refresh sees it unchanged */
+    ser_refresh(reader, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_follow(reader, 3, false);
+    ser_refresh(reader, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_follow(reader, 3, true);
+
+    /* appending overwrites the trailer, frames come through without it */
+    append_frames(writer, 3, 2);
+    ser_refresh(reader, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_follow(reader, 5, false);
+
+    ser_close_file(writer, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ser_refresh(reader, &status);
+    ser_refresh(reader, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_follow(reader, 5, true);
+
+    ser_close_file(reader, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+}
+
+START_TEST(follow_file) {
+    follow_writer(ser_open_file);
+} END_TEST
+
+START_TEST(follow_positional) {
+    follow_writer(ser_open_file_positional);
+} END_TEST
+
+START_TEST(follow_uncommitted_data) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    /* the header counts three frames, the last one is half written */
+    create_temp_ser(filepath, dir, &test_data_3x50, HDR_SIZE + 2 * 50 * 50 + 100);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, INVALID_STRUCTURE);
+
+    status = 0;
+    ser_open_file(&test_ser, filepath, READFOLLOW, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 2);
+
+    uint8_t buffer[50 * 50];
+    ser_read_frame(test_ser, buffer, 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(buffer, test_data_3x50.data + 50 * 50, sizeof(buffer));
+
+    ser_read_frame(test_ser, buffer, 2, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_IDX);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(follow_partial_frame_as_trailer) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    /* a fourth frame is part way written, exactly where a trailer would end */
+    SERTest3x50Structure test_data = test_data_3x50;
+    memset(test_data.trlr, 0x7f, sizeof(test_data.trlr));
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READFOLLOW, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 0, &status);
+    ck_assert_int_eq(status, INVALID_TRAILER_IDX);
+
+    /* the rest of the frame lands before the header counts it */
+    uint8_t rest[50 * 50 - sizeof(test_data.trlr)];
+    memset(rest, 0x7f, sizeof(rest));
+    FILE* file = fopen(filepath, "ab");
+    ck_assert_ptr_nonnull(file);
+    ck_assert_int_eq(fwrite(rest, 1, sizeof(rest), file), sizeof(rest));
+    fclose(file);
+
+    status = 0;
+    ser_refresh(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ser_read_timestamp(test_ser, &timestamp, 0, &status);
+    ck_assert_int_eq(status, INVALID_TRAILER_IDX);
+
+    int32_t frame_count = 0;
+    status = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 3);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(follow_not_supported) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(&test_ser, filepath, READFOLLOW, &status);
+    ck_assert_int_eq(status, NOT_SUPPORTED);
+    ck_assert_ptr_null(test_ser);
+
+    status = 0;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ser_refresh(test_ser, &status);
+    ck_assert_int_eq(status, NOT_SUPPORTED);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    test_ser = NULL;
+
+    ser_open_file_positional(&test_ser, filepath, READFOLLOW, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    serfile* clone_ser = NULL;
+    ser_clone_handle(test_ser, &clone_ser, &status);
+    ck_assert_int_eq(status, NOT_SUPPORTED);
+
+    /* a follow handle never writes */
+    status = 0;
+    uint8_t image_data[50 * 50] = {0};
+    ser_append_frame(test_ser, image_data, 0, &status);
+    ck_assert_int_eq(status, WRITE_ON_READONLY);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+Suite* follow_suite() {
+    Suite* s;
+    s = suite_create("Follow");
+
+    TCase* tc_follow = tcase_create("follow");
+    tcase_add_test(tc_follow, follow_file);
+    tcase_add_test(tc_follow, follow_positional);
+    tcase_add_test(tc_follow, follow_uncommitted_data);
+    tcase_add_test(tc_follow, follow_partial_frame_as_trailer);
+    tcase_add_test(tc_follow, follow_not_supported);
+    suite_add_tcase(s, tc_follow);
+
+    return s;
+}
+
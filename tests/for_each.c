@@ -0,0 +1,259 @@
+#include "suites.h"
+
+#include <check.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+#define FOR_EACH_FRAMES     64
+#define FOR_EACH_FRAME_SIZE (50 * 50)
+
+typedef struct {
+    int         visits[FOR_EACH_FRAMES];
+    int         bad_frames;
+    size_t      order[FOR_EACH_FRAMES];
+    size_t      completed;
+    pthread_t   caller;
+    pthread_t   threads[FOR_EACH_FRAMES];
+    size_t      abort_at;
+} for_each_state;
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+/* frame i is filled with i + 1 */
+static void create_for_each_ser(char* filepath, char* dir) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_file(&test_ser, filepath, &status);
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[FOR_EACH_FRAME_SIZE];
+    for (int i = 0; i < FOR_EACH_FRAMES; i++) {
+        memset(image_data, i + 1, sizeof(image_data));
+        ser_append_frame(test_ser, image_data, 0, &status);
+    }
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+}
+
+static int visit_frame(size_t idx, const void* frame, void* user) {
+    for_each_state* state = (for_each_state*)user;
+    const uint8_t* data = (const uint8_t*)frame;
+    if (data[0] != idx + 1 || data[FOR_EACH_FRAME_SIZE - 1] != idx + 1) {
+        __atomic_add_fetch(&state->bad_frames, 1, __ATOMIC_RELAXED);
+    }
+    __atomic_add_fetch(&state->visits[idx], 1, __ATOMIC_RELAXED);
+    state->threads[idx] = pthread_self();
+
+    /* the first half of the range is far more expensive */
+    if (idx < FOR_EACH_FRAMES / 2) {
+        usleep(2000);
+    }
+    return idx == state->abort_at;
+}
+
+static int complete_frame(size_t idx, const void* frame, void* user) {
+    (void)frame;
+    for_each_state* state = (for_each_state*)user;
+    state->order[state->completed++] = idx;
+    return 0;
+}
+
+static void check_visits(for_each_state* state, size_t first, size_t count) {
+    ck_assert_int_eq(state->bad_frames, 0);
+    for (size_t i = 0; i < FOR_EACH_FRAMES; i++) {
+        ck_assert_int_eq(state->visits[i], i >= first && i < first + count);
+    }
+}
+
+static void init_state(for_each_state* state) {
+    memset(state, 0, sizeof(*state));
+    state->caller = pthread_self();
+    state->abort_at = SIZE_MAX;
+}
+
+START_TEST(for_each_frame_file) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_for_each_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static for_each_state state;
+    init_state(&state);
+    serforeachopts opts = {4, false, complete_frame};
+    ser_for_each_frame(test_ser, 3, FOR_EACH_FRAMES - 3, visit_frame, &state, &opts, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_visits(&state, 3, FOR_EACH_FRAMES - 3);
+    ck_assert_int_eq(state.completed, FOR_EACH_FRAMES - 3);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(for_each_frame_ordered) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_for_each_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static for_each_state state;
+    init_state(&state);
+    serforeachopts opts = {4, true, complete_frame};
+    ser_for_each_frame(test_ser, 0, FOR_EACH_FRAMES, visit_frame, &state, &opts, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_visits(&state, 0, FOR_EACH_FRAMES);
+
+    ck_assert_int_eq(state.completed, FOR_EACH_FRAMES);
+    for (size_t i = 0; i < FOR_EACH_FRAMES; i++) {
+        ck_assert_int_eq(state.order[i], i);
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(for_each_frame_stealing) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_for_each_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the caller starts on the expensive half, the other thread helps out */
+    static for_each_state state;
+    init_state(&state);
+    serforeachopts opts = {2, false, NULL};
+    ser_for_each_frame(test_ser, 0, FOR_EACH_FRAMES, visit_frame, &state, &opts, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_visits(&state, 0, FOR_EACH_FRAMES);
+
+    size_t helped = 0;
+    for (size_t i = 0; i < FOR_EACH_FRAMES / 2; i++) {
+        helped += !pthread_equal(state.threads[i], state.caller);
+    }
+    ck_assert_uint_gt(helped, 0);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(for_each_frame_abort) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_for_each_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static for_each_state state;
+    init_state(&state);
+    state.abort_at = 5;
+    serforeachopts opts = {4, true, complete_frame};
+    ser_for_each_frame(test_ser, 0, FOR_EACH_FRAMES, visit_frame, &state, &opts, &status);
+    ck_assert_int_eq(status, CALLBACK_ABORTED);
+    ck_assert_int_le(state.completed, 5);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(for_each_frame_memory) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    static for_each_state state;
+    init_state(&state);
+    ser_for_each_frame(test_ser, 0, 4, visit_frame, &state, NULL, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_IDX);
+
+    status = 0;
+    ser_for_each_frame(test_ser, 0, 3, NULL, &state, NULL, &status);
+    ck_assert_int_eq(status, NULL_PARAM);
+
+    status = 0;
+    ser_for_each_frame(test_ser, 1, 0, visit_frame, &state, NULL, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(state.visits[1], 0);
+
+    status = 0;
+    serforeachopts opts = {0, true, complete_frame};
+    ser_for_each_frame(test_ser, 0, 3, visit_frame, &state, &opts, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(state.completed, 3);
+    for (size_t i = 0; i < 3; i++) {
+        ck_assert_int_eq(state.visits[i], 1);
+        ck_assert_int_eq(state.order[i], i);
+    }
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+Suite* for_each_suite() {
+    Suite* s;
+    s = suite_create("For Each");
+
+    TCase* tc_for_each = tcase_create("for_each_frame");
+    tcase_add_test(tc_for_each, for_each_frame_file);
+    tcase_add_test(tc_for_each, for_each_frame_ordered);
+    tcase_add_test(tc_for_each, for_each_frame_stealing);
+    tcase_add_test(tc_for_each, for_each_frame_abort);
+    tcase_add_test(tc_for_each, for_each_frame_memory);
+    suite_add_tcase(s, tc_for_each);
+
+    return s;
+}
+
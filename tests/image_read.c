@@ -147,6 +147,99 @@ START_TEST(image_read_null_ser) {
 
 } END_TEST
 
+START_TEST(read_frames_success) {
+    int status = 0;
+
+    size_t frame_size = test_data_3x50.hdr.image_width * test_data_3x50.hdr.image_height;
+    set_pattern_A(&test_data_3x50.data[0], frame_size);
+    set_pattern_B(&test_data_3x50.data[frame_size], frame_size);
+    set_pattern_C(&test_data_3x50.data[2 * frame_size], frame_size);
+
+    uint8_t buffer[2 * 50 * 50] = {0};
+    ser_read_frames(
+            test_ser_3x50,
+            buffer,
+            1,
+            2,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(buffer, &test_data_3x50.data[frame_size], sizeof(buffer));
+
+} END_TEST
+
+START_TEST(read_frames_oob_range) {
+    int status = 0;
+
+    uint8_t buffer[3 * 50 * 50] = {0};
+    ser_read_frames(
+            test_ser_3x50,
+            buffer,
+            1,
+            3,
+            &status
+    );
+    ck_assert_int_eq(status, INVALID_FRAME_IDX);
+
+    status = 0;
+    ser_read_frames(
+            test_ser_3x50,
+            buffer,
+            test_data_3x50.hdr.frame_count,
+            0,
+            &status
+    );
+    ck_assert_int_eq(status, INVALID_FRAME_IDX);
+
+} END_TEST
+
+START_TEST(frame_ptr_success) {
+    int status = 0;
+
+    size_t frame_size = test_data_3x50.hdr.image_width * test_data_3x50.hdr.image_height;
+
+    for (size_t i = 0; i < (size_t)test_data_3x50.hdr.frame_count; i++) {
+        const void* frame = NULL;
+        ser_get_frame_ptr(
+                test_ser_3x50,
+                i,
+                &frame,
+                &status
+        );
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_ptr_eq(frame, &test_data_3x50.data[i * frame_size]);
+    }
+
+} END_TEST
+
+START_TEST(frame_ptr_oob_idx) {
+    int status = 0;
+    const void* frame = NULL;
+
+    ser_get_frame_ptr(
+            test_ser_3x50,
+            test_data_3x50.hdr.frame_count,
+            &frame,
+            &status
+    );
+    ck_assert_int_eq(status, INVALID_FRAME_IDX);
+    ck_assert_ptr_null(frame);
+
+} END_TEST
+
+START_TEST(frame_ptr_null_out) {
+    int status = 0;
+
+    ser_get_frame_ptr(
+            test_ser_3x50,
+            0,
+            NULL,
+            &status
+    );
+    ck_assert_int_eq(status, NULL_DEST_BUFF);
+
+} END_TEST
+
 Suite* image_read_suite() {
     Suite* s;
     s = suite_create("Image Read");
@@ -160,6 +253,21 @@ Suite* image_read_suite() {
     tcase_add_test(tc_image_read, image_read_null_ser);
     suite_add_tcase(s, tc_image_read);
 
+    TCase* tc_read_frames;
+    tc_read_frames = tcase_create("read_frames");
+    tcase_add_checked_fixture(tc_read_frames, image_read_setup, image_read_teardown);
+    tcase_add_test(tc_read_frames, read_frames_success);
+    tcase_add_test(tc_read_frames, read_frames_oob_range);
+    suite_add_tcase(s, tc_read_frames);
+
+    TCase* tc_frame_ptr;
+    tc_frame_ptr = tcase_create("frame_ptr");
+    tcase_add_checked_fixture(tc_frame_ptr, image_read_setup, image_read_teardown);
+    tcase_add_test(tc_frame_ptr, frame_ptr_success);
+    tcase_add_test(tc_frame_ptr, frame_ptr_oob_idx);
+    tcase_add_test(tc_frame_ptr, frame_ptr_null_out);
+    suite_add_tcase(s, tc_frame_ptr);
+
     return s;
 }
 
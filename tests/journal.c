@@ -0,0 +1,349 @@
+#include "suites.h"
+
+#include <check.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* journalpath, char* dir) {
+    unlink(filepath);
+    unlink(journalpath);
+    rmdir(dir);
+}
+
+static long file_size_of(const char* path) {
+    struct stat st;
+    if (stat(path, &st)) {
+        return -1;
+    }
+    return (long)st.st_size;
+}
+
+/* appends 10 frames with a journal synced every 4 and dies */
+static void crash_while_capturing(const char* filepath, const char* journalpath) {
+    pid_t pid = fork();
+    ck_assert_int_ge(pid, 0);
+    if (pid == 0) {
+        int status = 0;
+        serfile* test_ser = NULL;
+        ser_open_file_positional(&test_ser, filepath, READWRITE, &status);
+        ser_set_journal(test_ser, journalpath, 4, &status);
+
+        uint8_t image_data[50 * 50];
+        for (int i = 0; i < 10; i++) {
+            memset(image_data, i + 1, sizeof(image_data));
+            ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE + i, &status);
+        }
+        _exit(status);
+    }
+
+    int child_status = 0;
+    waitpid(pid, &child_status, 0);
+    ck_assert(WIFEXITED(child_status));
+    ck_assert_int_eq(WEXITSTATUS(child_status), NO_ERROR);
+}
+
+START_TEST(journal_repair_after_crash) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    char journalpath[512];
+    SERTest3x50Structure test_data = test_data_3x50;
+    test_data.hdr.frame_count = 0;
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data.hdr));
+    snprintf(journalpath, 512, "%s/cserio_test_file.tsj", dir);
+    /* <- Setup */
+
+    crash_while_capturing(filepath, journalpath);
+
+    /* the trailer never made it, the last two timestamps were unsynced */
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, INVALID_STRUCTURE);
+    ck_assert_int_eq(file_size_of(journalpath), 8 * sizeof(int64_t));
+
+    status = 0;
+    ser_repair_file(filepath, journalpath, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(
+            file_size_of(filepath),
+            HDR_SIZE + 8 * (50 * 50 + sizeof(int64_t))
+    );
+
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 8);
+
+    uint8_t buffer[50 * 50];
+    for (int i = 0; i < 8; i++) {
+        ser_read_frame(test_ser, buffer, i, &status);
+        ck_assert_int_eq(buffer[0], i + 1);
+
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, i, &status);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + i);
+    }
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, journalpath, dir);
+} END_TEST
+
+START_TEST(journal_existing_frames) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    char journalpath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    snprintf(journalpath, 512, "%s/cserio_test_file.tsj", dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READWRITE, &status);
+    ser_set_journal(test_ser, journalpath, 100, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the trailer already on disk is journaled straight away */
+    ck_assert_int_eq(file_size_of(journalpath), 3 * sizeof(int64_t));
+
+    uint8_t image_data[50 * 50] = {0};
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ser_flush(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(file_size_of(journalpath), 4 * sizeof(int64_t));
+
+    /* a clean close leaves only the SER behind */
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(file_size_of(journalpath), -1);
+
+    serinfo info;
+    ser_probe(filepath, &info, &status);
+    ck_assert(info.valid);
+    ck_assert_int_eq(info.frame_count, 4);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, journalpath, dir);
+} END_TEST
+
+START_TEST(journal_stop) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    char journalpath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    snprintf(journalpath, 512, "%s/cserio_test_file.tsj", dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READWRITE, &status);
+    ser_set_journal(test_ser, journalpath, 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(file_size_of(journalpath), 3 * sizeof(int64_t));
+
+    ser_set_journal(test_ser, NULL, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(file_size_of(journalpath), -1);
+
+    uint8_t image_data[50 * 50] = {0};
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, journalpath, dir);
+} END_TEST
+
+START_TEST(journal_repair_valid) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    char journalpath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    snprintf(journalpath, 512, "%s/cserio_test_file.tsj", dir);
+    /* <- Setup */
+
+    /* nothing to repair, so no journal is needed */
+    int status = 0;
+    ser_repair_file(filepath, journalpath, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(file_size_of(filepath), sizeof(test_data_3x50));
+
+    /* a truncated trailer cannot be rebuilt without the journal */
+    ck_assert_int_eq(truncate(filepath, sizeof(test_data_3x50) - 1), 0);
+    ser_repair_file(filepath, journalpath, &status);
+    ck_assert_int_eq(status, FILE_DNE);
+
+    status = 0;
+    ser_repair_file(NULL, journalpath, &status);
+    ck_assert_int_eq(status, NULL_PATH);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, journalpath, dir);
+} END_TEST
+
+START_TEST(journal_invalid_args) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+    ser_set_journal(test_ser, "/tmp/cserio_test_journal.tsj", 1, &status);
+    ck_assert_int_eq(status, WRITE_ON_READONLY);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+
+    test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ser_set_journal(test_ser, "/tmp/cserio_test_journal.tsj", 0, &status);
+    ck_assert_int_eq(status, INVALID_SET_VALUE);
+
+    status = 0;
+    ser_set_journal(NULL, NULL, 1, &status);
+    ck_assert_int_eq(status, NULL_SPTR);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+/* appends 3 frames to a memory capture while the journal may only 
+ * hold 2 entries, then lifts the limit and appends again */
+static int append_past_journal_limit(const char* journalpath) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ser_write_image_width(test_ser, 2, &status);
+    ser_write_image_height(test_ser, 2, &status);
+    ser_write_date_time(test_ser, TEST_TIMESTAMP_VALUE, &status);
+    ser_set_journal(test_ser, journalpath, 1, &status);
+    if (status) {
+        return 1;
+    }
+
+    struct rlimit limit;
+    getrlimit(RLIMIT_FSIZE, &limit);
+    rlim_t soft_limit = limit.rlim_cur;
+    limit.rlim_cur = 2 * sizeof(int64_t);
+    signal(SIGXFSZ, SIG_IGN);
+    setrlimit(RLIMIT_FSIZE, &limit);
+
+    uint8_t image_data[2 * 2] = {0};
+    for (int i = 0; i < 2; i++) {
+        ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE + i, &status);
+    }
+    if (status) {
+        return 2;
+    }
+
+    /* a timestamp that cannot be journaled keeps its frame out */
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE + 2, &status);
+    int32_t frame_count = 0;
+    int count_status = 0;
+    ser_read_frame_count(test_ser, &frame_count, &count_status);
+    if (status != JOURNAL_WRITE_ERROR || frame_count != 2) {
+        return 3;
+    }
+
+    limit.rlim_cur = soft_limit;
+    setrlimit(RLIMIT_FSIZE, &limit);
+    status = 0;
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE + 3, &status);
+    ser_flush(test_ser, &status);
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    if (status || frame_count != 3) {
+        return 4;
+    }
+    return 0;
+}
+
+START_TEST(journal_write_failure) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char journalpath[512];
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(journalpath, 512, "%s/cserio_test_file.tsj", dir);
+    /* <- Setup */
+
+    pid_t pid = fork();
+    ck_assert_int_ge(pid, 0);
+    if (pid == 0) {
+        _exit(append_past_journal_limit(journalpath));
+    }
+
+    int child_status = 0;
+    waitpid(pid, &child_status, 0);
+    ck_assert(WIFEXITED(child_status));
+    ck_assert_int_eq(WEXITSTATUS(child_status), 0);
+
+    /* the failed entry was rewritten by the next frame */
+    int64_t timestamps[3] = {0};
+    FILE* journal = fopen(journalpath, "rb");
+    ck_assert_ptr_nonnull(journal);
+    ck_assert_int_eq(fread(timestamps, sizeof(int64_t), 3, journal), 3);
+    fclose(journal);
+    ck_assert_int_eq(file_size_of(journalpath), 3 * sizeof(int64_t));
+    ck_assert_int_eq(timestamps[0], TEST_TIMESTAMP_VALUE);
+    ck_assert_int_eq(timestamps[1], TEST_TIMESTAMP_VALUE + 1);
+    ck_assert_int_eq(timestamps[2], TEST_TIMESTAMP_VALUE + 3);
+
+    /* Teardown -> */
+    unlink(journalpath);
+    rmdir(dir);
+} END_TEST
+
+Suite* journal_suite() {
+    Suite* s;
+    s = suite_create("Journal");
+
+    TCase* tc_journal = tcase_create("journal");
+    tcase_add_test(tc_journal, journal_repair_after_crash);
+    tcase_add_test(tc_journal, journal_existing_frames);
+    tcase_add_test(tc_journal, journal_stop);
+    tcase_add_test(tc_journal, journal_repair_valid);
+    tcase_add_test(tc_journal, journal_invalid_args);
+    tcase_add_test(tc_journal, journal_write_failure);
+    suite_add_tcase(s, tc_journal);
+
+    return s;
+}
+
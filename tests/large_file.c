@@ -0,0 +1,233 @@
+#include "suites.h"
+
+#include <check.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+#define LARGE_WIDTH         1024
+#define LARGE_HEIGHT        1024
+#define LARGE_FRAME_SIZE    ((uint64_t)LARGE_WIDTH * LARGE_HEIGHT)
+#define LARGE_FRAME_COUNT   5000
+#define LARGE_TRAILER_KEY   (HDR_SIZE + LARGE_FRAME_SIZE * LARGE_FRAME_COUNT)
+
+/*  Builds a sparse SER whose last frame and trailer sit past 4 GB.
+ *  Only the header, the last frame and the trailer hold data.
+ */
+static void create_large_ser(char* filepath, char* dir) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    int fd = open(filepath, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    uint8_t header[HDR_SIZE];
+    memcpy(header, &test_data_3x50, HDR_SIZE);
+    int32_t width = LARGE_WIDTH;
+    int32_t height = LARGE_HEIGHT;
+    int32_t frame_count = LARGE_FRAME_COUNT;
+    memcpy(header + IMAGEWIDTH_KEY, &width, IMAGEWIDTH_LEN);
+    memcpy(header + IMAGEHEIGHT_KEY, &height, IMAGEHEIGHT_LEN);
+    memcpy(header + FRAMECOUNT_KEY, &frame_count, FRAMECOUNT_LEN);
+    ck_assert_int_eq(pwrite(fd, header, HDR_SIZE, 0), HDR_SIZE);
+
+    uint8_t* frame = (uint8_t*)malloc(LARGE_FRAME_SIZE);
+    memset(frame, 0xA5, LARGE_FRAME_SIZE);
+    off_t last_frame_key = HDR_SIZE + LARGE_FRAME_SIZE * (LARGE_FRAME_COUNT - 1);
+    ck_assert_int_eq(pwrite(fd, frame, LARGE_FRAME_SIZE, last_frame_key), LARGE_FRAME_SIZE);
+    free(frame);
+
+    int64_t timestamps[LARGE_FRAME_COUNT];
+    for (int i = 0; i < LARGE_FRAME_COUNT; i++) {
+        timestamps[i] = TEST_TIMESTAMP_VALUE + i;
+    }
+    ck_assert_int_eq(
+            pwrite(fd, timestamps, sizeof(timestamps), LARGE_TRAILER_KEY),
+            sizeof(timestamps)
+    );
+
+    close(fd);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+static void check_last_frame(serfile* test_ser) {
+    int status = 0;
+    uint8_t* buffer = (uint8_t*)malloc(LARGE_FRAME_SIZE);
+    ser_read_frame(test_ser, buffer, LARGE_FRAME_COUNT - 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(buffer[0], 0xA5);
+    ck_assert_int_eq(buffer[LARGE_FRAME_SIZE - 1], 0xA5);
+    free(buffer);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, LARGE_FRAME_COUNT - 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + LARGE_FRAME_COUNT - 1);
+}
+
+START_TEST(large_file_open) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_large_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    check_last_frame(test_ser);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(large_file_open_positional) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_large_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    check_last_frame(test_ser);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(large_file_open_mapped) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_large_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    check_last_frame(test_ser);
+
+    const void* frame = NULL;
+    ser_get_frame_ptr(test_ser, LARGE_FRAME_COUNT - 1, &frame, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(((const uint8_t*)frame)[LARGE_FRAME_SIZE - 1], 0xA5);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(large_file_append) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_large_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t* image_data = (uint8_t*)malloc(LARGE_FRAME_SIZE);
+    memset(image_data, 0x5A, LARGE_FRAME_SIZE);
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    struct stat st;
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_uint_eq(
+            (uint64_t)st.st_size,
+            LARGE_TRAILER_KEY + LARGE_FRAME_SIZE + (LARGE_FRAME_COUNT + 1) * sizeof(int64_t)
+    );
+
+    test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t* buffer = (uint8_t*)malloc(LARGE_FRAME_SIZE);
+    ser_read_frame(test_ser, buffer, LARGE_FRAME_COUNT, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(buffer, image_data, LARGE_FRAME_SIZE);
+    free(buffer);
+    free(image_data);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, LARGE_FRAME_COUNT, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(large_file_header_overflow) {
+    /* 65535 x 65535 RGB16 frames, INT32_MAX of them, overflow 64 bits */
+    SERTest3x50Structure test_data = test_data_3x50;
+    uint8_t* header = (uint8_t*)&test_data;
+    int32_t width = 65535;
+    int32_t height = 65535;
+    int32_t color_id = RGB;
+    int32_t pixel_depth = 16;
+    int32_t frame_count = INT32_MAX;
+    memcpy(header + IMAGEWIDTH_KEY, &width, IMAGEWIDTH_LEN);
+    memcpy(header + IMAGEHEIGHT_KEY, &height, IMAGEHEIGHT_LEN);
+    memcpy(header + COLORID_KEY, &color_id, COLORID_LEN);
+    memcpy(header + PIXELDEPTHPERPLANE_KEY, &pixel_depth, PIXELDEPTHPERPLANE_LEN);
+    memcpy(header + FRAMECOUNT_KEY, &frame_count, FRAMECOUNT_LEN);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(&test_ser, header, sizeof(test_data), READONLY, &status);
+    ck_assert_int_eq(status, INVALID_STRUCTURE);
+    ck_assert_ptr_null(test_ser);
+} END_TEST
+
+Suite* large_file_suite() {
+    Suite* s;
+    s = suite_create("Large File");
+
+    TCase* tc_large_file = tcase_create("large_file");
+    tcase_set_timeout(tc_large_file, 60);
+    tcase_add_test(tc_large_file, large_file_open);
+    tcase_add_test(tc_large_file, large_file_open_positional);
+    tcase_add_test(tc_large_file, large_file_open_mapped);
+    tcase_add_test(tc_large_file, large_file_append);
+    tcase_add_test(tc_large_file, large_file_header_overflow);
+    suite_add_tcase(s, tc_large_file);
+
+    return s;
+}
+
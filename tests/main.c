@@ -1,13 +1,14 @@
 
-#include <check.h>
-#include <stdlib.h>
-
+/* the implementation has to come before any system header */
 #if defined(UNITY_TEST)
 #define CSERIO_IMPLEMENTATION
 #endif
 
 #include "../cserio.h"
 
+#include <check.h>
+#include <stdlib.h>
+
 #include "suites.h"
 
 #define OUTPUT_MODE     CK_NORMAL
@@ -58,6 +59,62 @@ int main() {
     number_failed = srunner_ntests_failed(open_file_sr);
     srunner_free(open_file_sr);
 
+    Suite* open_mapped_s; 
+    open_mapped_s = open_mapped_suite();
+    SRunner* open_mapped_sr = srunner_create(open_mapped_s);
+    srunner_run_all(open_mapped_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(open_mapped_sr);
+    srunner_free(open_mapped_sr);
+
+    Suite* open_positional_s; 
+    open_positional_s = open_positional_suite();
+    SRunner* open_positional_sr = srunner_create(open_positional_s);
+    srunner_run_all(open_positional_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(open_positional_sr);
+    srunner_free(open_positional_sr);
+
+    Suite* open_custom_s; 
+    open_custom_s = open_custom_suite();
+    SRunner* open_custom_sr = srunner_create(open_custom_s);
+    srunner_run_all(open_custom_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(open_custom_sr);
+    srunner_free(open_custom_sr);
+
+    Suite* direct_io_s; 
+    direct_io_s = direct_io_suite();
+    SRunner* direct_io_sr = srunner_create(direct_io_s);
+    srunner_run_all(direct_io_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(direct_io_sr);
+    srunner_free(direct_io_sr);
+
+    Suite* probe_s; 
+    probe_s = probe_suite();
+    SRunner* probe_sr = srunner_create(probe_s);
+    srunner_run_all(probe_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(probe_sr);
+    srunner_free(probe_sr);
+
+    Suite* clone_s; 
+    clone_s = clone_suite();
+    SRunner* clone_sr = srunner_create(clone_s);
+    srunner_run_all(clone_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(clone_sr);
+    srunner_free(clone_sr);
+
+    Suite* follow_s; 
+    follow_s = follow_suite();
+    SRunner* follow_sr = srunner_create(follow_s);
+    srunner_run_all(follow_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(follow_sr);
+    srunner_free(follow_sr);
+
+    Suite* salvage_s; 
+    salvage_s = salvage_suite();
+    SRunner* salvage_sr = srunner_create(salvage_s);
+    srunner_run_all(salvage_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(salvage_sr);
+    srunner_free(salvage_sr);
+
     Suite* header_read_s; 
     header_read_s = header_read_suite();
     SRunner* header_read_sr = srunner_create(header_read_s);
@@ -93,6 +150,97 @@ int main() {
     number_failed = srunner_ntests_failed(image_write_sr);
     srunner_free(image_write_sr);
 
+    Suite* reserve_s; 
+    reserve_s = reserve_suite();
+    SRunner* reserve_sr = srunner_create(reserve_s);
+    srunner_run_all(reserve_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(reserve_sr);
+    srunner_free(reserve_sr);
+
+    Suite* capacity_s; 
+    capacity_s = capacity_suite();
+    SRunner* capacity_sr = srunner_create(capacity_s);
+    srunner_run_all(capacity_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(capacity_sr);
+    srunner_free(capacity_sr);
+
+    Suite* async_read_s; 
+    async_read_s = async_read_suite();
+    SRunner* async_read_sr = srunner_create(async_read_s);
+    srunner_run_all(async_read_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(async_read_sr);
+    srunner_free(async_read_sr);
+
+    Suite* parallel_read_s; 
+    parallel_read_s = parallel_read_suite();
+    SRunner* parallel_read_sr = srunner_create(parallel_read_s);
+    srunner_run_all(parallel_read_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(parallel_read_sr);
+    srunner_free(parallel_read_sr);
+
+    Suite* for_each_s; 
+    for_each_s = for_each_suite();
+    SRunner* for_each_sr = srunner_create(for_each_s);
+    srunner_run_all(for_each_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(for_each_sr);
+    srunner_free(for_each_sr);
+
+    Suite* access_hint_s; 
+    access_hint_s = access_hint_suite();
+    SRunner* access_hint_sr = srunner_create(access_hint_s);
+    srunner_run_all(access_hint_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(access_hint_sr);
+    srunner_free(access_hint_sr);
+
+    Suite* commit_s; 
+    commit_s = commit_suite();
+    SRunner* commit_sr = srunner_create(commit_s);
+    srunner_run_all(commit_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(commit_sr);
+    srunner_free(commit_sr);
+
+    Suite* journal_s; 
+    journal_s = journal_suite();
+    SRunner* journal_sr = srunner_create(journal_s);
+    srunner_run_all(journal_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(journal_sr);
+    srunner_free(journal_sr);
+
+    Suite* capture_s; 
+    capture_s = capture_suite();
+    SRunner* capture_sr = srunner_create(capture_s);
+    srunner_run_all(capture_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(capture_sr);
+    srunner_free(capture_sr);
+
+    Suite* async_append_s; 
+    async_append_s = async_append_suite();
+    SRunner* async_append_sr = srunner_create(async_append_s);
+    srunner_run_all(async_append_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(async_append_sr);
+    srunner_free(async_append_sr);
+
+    Suite* rollover_s; 
+    rollover_s = rollover_suite();
+    SRunner* rollover_sr = srunner_create(rollover_s);
+    srunner_run_all(rollover_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(rollover_sr);
+    srunner_free(rollover_sr);
+
+    Suite* coroutine_s; 
+    coroutine_s = coroutine_suite();
+    SRunner* coroutine_sr = srunner_create(coroutine_s);
+    srunner_run_all(coroutine_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(coroutine_sr);
+    srunner_free(coroutine_sr);
+
+    Suite* large_file_s; 
+    large_file_s = large_file_suite();
+    SRunner* large_file_sr = srunner_create(large_file_s);
+    srunner_run_all(large_file_sr, OUTPUT_MODE);
+    number_failed = srunner_ntests_failed(large_file_sr);
+    srunner_free(large_file_sr);
+
     Suite* trlr_read_s; 
     trlr_read_s = trailer_read_suite();
     SRunner* trlr_read_sr = srunner_create(trlr_read_s);
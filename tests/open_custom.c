@@ -0,0 +1,296 @@
+#include "suites.h"
+
+#include <check.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+typedef struct {
+    uint8_t data[sizeof(SERTest3x50Structure) + 50 * 50 + sizeof(int64_t)];
+    size_t size;
+    int reads;
+    int writes;
+    int closes;
+} custom_store;
+
+static size_t custom_read(void* context, void* buffer, size_t size, uint64_t offset) {
+    custom_store* store = (custom_store*)context;
+    store->reads++;
+    if (offset >= store->size) {
+        return 0;
+    }
+    if (offset + size > store->size) {
+        size = store->size - offset;
+    }
+    memcpy(buffer, store->data + offset, size);
+    return size;
+}
+
+static size_t custom_write(void* context, const void* data, size_t size, uint64_t offset) {
+    custom_store* store = (custom_store*)context;
+    store->writes++;
+    if (offset + size > sizeof(store->data)) {
+        return 0;
+    }
+    memcpy(store->data + offset, data, size);
+    if (offset + size > store->size) {
+        store->size = offset + size;
+    }
+    return size;
+}
+
+static uint64_t custom_size(void* context) {
+    return ((custom_store*)context)->size;
+}
+
+static int custom_close(void* context) {
+    ((custom_store*)context)->closes++;
+    return 0;
+}
+
+static serbackend custom_backend(custom_store* store) {
+    serbackend backend = {
+        .context = store,
+        .reader = custom_read,
+        .writer = custom_write,
+        .sizer = custom_size,
+        .flusher = NULL,
+        .closer = custom_close,
+        .lender = NULL
+    };
+    return backend;
+}
+
+START_TEST(open_custom_success) {
+    static custom_store store;
+    memset(&store, 0, sizeof(store));
+    memcpy(store.data, &test_data_3x50, sizeof(test_data_3x50));
+    store.size = sizeof(test_data_3x50);
+    serbackend backend = custom_backend(&store);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_custom(&test_ser, &backend, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_gt(store.reads, 0);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(store.closes, 1);
+    ck_assert_int_eq(store.writes, 0);
+} END_TEST
+
+START_TEST(open_custom_append_frame) {
+    static custom_store store;
+    memset(&store, 0, sizeof(store));
+    memcpy(store.data, &test_data_3x50, sizeof(test_data_3x50));
+    store.size = sizeof(test_data_3x50);
+    serbackend backend = custom_backend(&store);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_custom(&test_ser, &backend, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50];
+    memset(image_data, 0xA0, sizeof(image_data));
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(store.size, sizeof(store.data));
+    ck_assert_mem_eq(store.data + HDR_SIZE + 3 * sizeof(image_data), image_data, sizeof(image_data));
+} END_TEST
+
+START_TEST(create_custom_success) {
+    static custom_store store;
+    memset(&store, 0, sizeof(store));
+    serbackend backend = custom_backend(&store);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_custom(&test_ser, &backend, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(store.size, HDR_SIZE);
+
+    int32_t little_endian = 0;
+    ser_read_little_endian(test_ser, &little_endian, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(little_endian, LITTLEENDIAN_TRUE);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(store.closes, 1);
+} END_TEST
+
+START_TEST(custom_header_single_io) {
+    static custom_store store;
+    memset(&store, 0, sizeof(store));
+    serbackend backend = custom_backend(&store);
+
+    /* the whole header goes out in one write */
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_custom(&test_ser, &backend, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(store.writes, 1);
+    ser_close_file(test_ser, &status);
+
+    /* and comes back in one read, the trailer is left on disk */
+    memcpy(store.data, &test_data_3x50, sizeof(test_data_3x50));
+    store.size = sizeof(test_data_3x50);
+    store.reads = 0;
+
+    test_ser = NULL;
+    ser_open_custom(&test_ser, &backend, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(store.reads, 1);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 3);
+
+    char telescope[TELESCOPE_LEN];
+    ser_read_telescope(test_ser, telescope, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(telescope, (uint8_t*)&test_data_3x50 + TELESCOPE_KEY, TELESCOPE_LEN);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(open_custom_lazy_trailer) {
+    static custom_store store;
+    memset(&store, 0, sizeof(store));
+    memcpy(store.data, &test_data_3x50, sizeof(test_data_3x50));
+    store.size = sizeof(test_data_3x50);
+    serbackend backend = custom_backend(&store);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_custom(&test_ser, &backend, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(store.reads, 1);
+
+    /* the first timestamp loads the whole trailer, later ones are free */
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 2, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, test_data_3x50.trlr[2]);
+    ck_assert_int_eq(store.reads, 2);
+
+    ser_read_timestamp(test_ser, &timestamp, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(store.reads, 2);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(open_custom_lazy_trailer_append) {
+    static custom_store store;
+    memset(&store, 0, sizeof(store));
+    memcpy(store.data, &test_data_3x50, sizeof(test_data_3x50));
+    store.size = sizeof(test_data_3x50);
+    serbackend backend = custom_backend(&store);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_custom(&test_ser, &backend, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the appended frame overwrites the trailer on disk */
+    uint8_t image_data[50 * 50] = {0};
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE + 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, test_data_3x50.trlr[0]);
+
+    ser_read_timestamp(test_ser, &timestamp, 3, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + 1);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(open_custom_invalid_structure) {
+    static custom_store store;
+    memset(&store, 0, sizeof(store));
+    memcpy(store.data, &test_data_3x50, sizeof(test_data_3x50));
+    store.size = sizeof(test_data_3x50) - 1;
+    serbackend backend = custom_backend(&store);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_custom(&test_ser, &backend, READONLY, &status);
+    ck_assert_int_eq(status, INVALID_STRUCTURE);
+    ck_assert_ptr_null(test_ser);
+    ck_assert_int_eq(store.closes, 0);
+} END_TEST
+
+START_TEST(open_custom_missing_callback) {
+    static custom_store store;
+    serbackend backend = custom_backend(&store);
+    backend.sizer = NULL;
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_custom(&test_ser, &backend, READONLY, &status);
+    ck_assert_int_eq(status, NULL_PARAM);
+    ck_assert_ptr_null(test_ser);
+} END_TEST
+
+START_TEST(open_custom_missing_writer) {
+    static custom_store store;
+    memset(&store, 0, sizeof(store));
+    memcpy(store.data, &test_data_3x50, sizeof(test_data_3x50));
+    store.size = sizeof(test_data_3x50);
+    serbackend backend = custom_backend(&store);
+    backend.writer = NULL;
+
+    /* a read only backend cannot back a writable handle */
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_custom(&test_ser, &backend, READWRITE, &status);
+    ck_assert_int_eq(status, INVALID_SET_VALUE);
+    ck_assert_ptr_null(test_ser);
+
+    status = 0;
+    ser_open_custom(&test_ser, &backend, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(store.closes, 1);
+} END_TEST
+
+Suite* open_custom_suite() {
+    Suite* s;
+    s = suite_create("Open Custom");
+
+    TCase* tc_open_custom = tcase_create("open_custom");
+    tcase_add_test(tc_open_custom, open_custom_success);
+    tcase_add_test(tc_open_custom, open_custom_append_frame);
+    tcase_add_test(tc_open_custom, create_custom_success);
+    tcase_add_test(tc_open_custom, custom_header_single_io);
+    tcase_add_test(tc_open_custom, open_custom_lazy_trailer);
+    tcase_add_test(tc_open_custom, open_custom_lazy_trailer_append);
+    tcase_add_test(tc_open_custom, open_custom_invalid_structure);
+    tcase_add_test(tc_open_custom, open_custom_missing_callback);
+    tcase_add_test(tc_open_custom, open_custom_missing_writer);
+    suite_add_tcase(s, tc_open_custom);
+
+    return s;
+}
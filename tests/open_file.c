@@ -64,6 +64,35 @@ START_TEST(open_file_success) {
     destroy_temp_ser(filepath, dir);
 } END_TEST
 
+START_TEST(open_file_frame_ptr_not_supported) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+    
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    const void* frame = NULL;
+    ser_get_frame_ptr(test_ser, 0, &frame, &status);
+    ck_assert_int_eq(status, NOT_SUPPORTED);
+    ck_assert_ptr_null(frame);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
 START_TEST(open_file_no_trailer) {
     char dir[] = "/tmp/cserio_testXXXXXX";
     char filepath[512];
@@ -307,6 +336,7 @@ Suite* open_file_suite() {
 
     TCase* tc_open_file = tcase_create("open_file");
     tcase_add_test(tc_open_file, open_file_success);
+    tcase_add_test(tc_open_file, open_file_frame_ptr_not_supported);
     tcase_add_test(tc_open_file, open_file_no_trailer);
     tcase_add_test(tc_open_file, open_file_no_trailer_fail);
     tcase_add_test(tc_open_file, open_file_with_trailer_fail);
@@ -0,0 +1,254 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+START_TEST(open_mapped_success) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    char observer[OBSERVER_LEN] = {0};
+    ser_read_observer(test_ser, observer, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(observer, test_data_3x50.hdr.observer, OBSERVER_LEN);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 2, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_mapped_read_frame) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = test_data_3x50;
+    for (size_t i = 0; i < sizeof(test_data.data); i++) {
+        test_data.data[i] = (uint8_t)(i * 7);
+    }
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t buffer[50 * 50] = {0};
+    ser_read_frame(test_ser, buffer, 1, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(buffer, test_data.data + sizeof(buffer), sizeof(buffer));
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_mapped_frame_ptr) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = test_data_3x50;
+    memset(test_data.data + 2 * 50 * 50, 0x5A, 50 * 50);
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    const void* frame = NULL;
+    ser_get_frame_ptr(test_ser, 2, &frame, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(frame, test_data.data + 2 * 50 * 50, 50 * 50);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_mapped_append_frame) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    size_t init_file_size = sizeof(test_data_3x50);
+    create_temp_ser(filepath, dir, &test_data_3x50, init_file_size);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(
+            &test_ser,
+            filepath,
+            READWRITE,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50] = {0};
+    memset(image_data, 0xA0, sizeof(image_data));
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* growth step must have been trimmed and the trailer rewritten */
+    struct stat st;
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, init_file_size + sizeof(image_data) + sizeof(int64_t));
+
+    test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t buffer[50 * 50] = {0};
+    ser_read_frame(test_ser, buffer, 3, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(buffer, image_data, sizeof(image_data));
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_mapped_readonly_write) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_write_lu_id(test_ser, 1, &status);
+    ck_assert_int_eq(status, WRITE_ON_READONLY);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_mapped_invalid_structure) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50) - 1);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, INVALID_STRUCTURE);
+    ck_assert_ptr_null(test_ser);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_mapped_invalid_path) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(
+            &test_ser,
+            "/tmp/cserio_test_missing_file.ser",
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, FILE_DNE);
+    ck_assert_ptr_null(test_ser);
+} END_TEST
+
+Suite* open_mapped_suite() {
+    Suite* s;
+    s = suite_create("Open Mapped");
+
+    TCase* tc_open_mapped = tcase_create("open_mapped");
+    tcase_add_test(tc_open_mapped, open_mapped_success);
+    tcase_add_test(tc_open_mapped, open_mapped_read_frame);
+    tcase_add_test(tc_open_mapped, open_mapped_frame_ptr);
+    tcase_add_test(tc_open_mapped, open_mapped_append_frame);
+    tcase_add_test(tc_open_mapped, open_mapped_readonly_write);
+    tcase_add_test(tc_open_mapped, open_mapped_invalid_structure);
+    tcase_add_test(tc_open_mapped, open_mapped_invalid_path);
+    suite_add_tcase(s, tc_open_mapped);
+
+    return s;
+}
@@ -0,0 +1,255 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+START_TEST(open_positional_success) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(frame_count, test_data_3x50.hdr.frame_count);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_positional_append_frame) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    size_t init_file_size = sizeof(test_data_3x50);
+    create_temp_ser(filepath, dir, &test_data_3x50, init_file_size);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(
+            &test_ser,
+            filepath,
+            READWRITE,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50] = {0};
+    memset(image_data, 0xA0, sizeof(image_data));
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t buffer[50 * 50] = {0};
+    ser_read_frame(test_ser, buffer, 3, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(buffer, image_data, sizeof(image_data));
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    struct stat st;
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, init_file_size + sizeof(image_data) + sizeof(int64_t));
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+typedef struct {
+    serfile* ser;
+    size_t idx;
+    int failures;
+} positional_reader_args;
+
+static void* positional_reader(void* arg) {
+    positional_reader_args* args = (positional_reader_args*)arg;
+    uint8_t buffer[50 * 50];
+
+    for (int i = 0; i < 200; i++) {
+        int status = 0;
+        ser_read_frame(args->ser, buffer, args->idx, &status);
+        if (status || buffer[0] != args->idx || buffer[sizeof(buffer) - 1] != args->idx) {
+            args->failures++;
+        }
+    }
+
+    return NULL;
+}
+
+START_TEST(open_positional_concurrent_read) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = test_data_3x50;
+    for (size_t i = 0; i < 3; i++) {
+        memset(test_data.data + i * 50 * 50, (int)i, 50 * 50);
+    }
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    pthread_t threads[3];
+    positional_reader_args args[3];
+    for (size_t i = 0; i < 3; i++) {
+        args[i].ser = test_ser;
+        args[i].idx = i;
+        args[i].failures = 0;
+        pthread_create(&threads[i], NULL, positional_reader, &args[i]);
+    }
+    for (size_t i = 0; i < 3; i++) {
+        pthread_join(threads[i], NULL);
+        ck_assert_int_eq(args[i].failures, 0);
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+static void* positional_timestamp_reader(void* arg) {
+    positional_reader_args* args = (positional_reader_args*)arg;
+
+    for (int i = 0; i < 200; i++) {
+        int status = 0;
+        int64_t timestamp = 0;
+        ser_read_timestamp(args->ser, &timestamp, args->idx, &status);
+        if (status || timestamp != TEST_TIMESTAMP_VALUE + (int64_t)args->idx) {
+            args->failures++;
+        }
+    }
+
+    return NULL;
+}
+
+START_TEST(open_positional_concurrent_timestamps) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = test_data_3x50;
+    for (size_t i = 0; i < 3; i++) {
+        test_data.trlr[i] = TEST_TIMESTAMP_VALUE + i;
+    }
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data));
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* the trailer has not been touched yet, every thread finds it pending */
+    pthread_t threads[6];
+    positional_reader_args args[6];
+    for (size_t i = 0; i < 6; i++) {
+        args[i].ser = test_ser;
+        args[i].idx = i % 3;
+        args[i].failures = 0;
+        pthread_create(&threads[i], NULL, positional_timestamp_reader, &args[i]);
+    }
+    for (size_t i = 0; i < 6; i++) {
+        pthread_join(threads[i], NULL);
+        ck_assert_int_eq(args[i].failures, 0);
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(open_positional_invalid_structure) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, HDR_SIZE - 1);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(
+            &test_ser,
+            filepath,
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, INVALID_STRUCTURE);
+    ck_assert_ptr_null(test_ser);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+Suite* open_positional_suite() {
+    Suite* s;
+    s = suite_create("Open Positional");
+
+    TCase* tc_open_positional = tcase_create("open_positional");
+    tcase_add_test(tc_open_positional, open_positional_success);
+    tcase_add_test(tc_open_positional, open_positional_append_frame);
+    tcase_add_test(tc_open_positional, open_positional_concurrent_read);
+    tcase_add_test(tc_open_positional, open_positional_concurrent_timestamps);
+    tcase_add_test(tc_open_positional, open_positional_invalid_structure);
+    suite_add_tcase(s, tc_open_positional);
+
+    return s;
+}
@@ -0,0 +1,233 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+#define PARALLEL_FRAMES     64
+#define PARALLEL_FRAME_SIZE (50 * 50)
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+/* frame i is filled with i + 1 */
+static void create_parallel_ser(char* filepath, char* dir) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_file(&test_ser, filepath, &status);
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[PARALLEL_FRAME_SIZE];
+    for (int i = 0; i < PARALLEL_FRAMES; i++) {
+        memset(image_data, i + 1, sizeof(image_data));
+        ser_append_frame(test_ser, image_data, 0, &status);
+    }
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+}
+
+static void check_frames(const uint8_t* frames, size_t first, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        const uint8_t* frame = frames + i * PARALLEL_FRAME_SIZE;
+        ck_assert_int_eq(frame[0], first + i + 1);
+        ck_assert_int_eq(frame[PARALLEL_FRAME_SIZE - 1], first + i + 1);
+    }
+}
+
+static void read_parallel(serfile* test_ser) {
+    int status = 0;
+    uint8_t* frames = (uint8_t*)malloc(PARALLEL_FRAMES * PARALLEL_FRAME_SIZE);
+
+    /* default chunking, the whole file fits one chunk */
+    ser_read_frames_parallel(test_ser, frames, 0, PARALLEL_FRAMES, 4, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_frames(frames, 0, PARALLEL_FRAMES);
+
+    /* small uneven chunks spread across the threads */
+    memset(frames, 0, PARALLEL_FRAMES * PARALLEL_FRAME_SIZE);
+    ser_set_parallel_chunk(test_ser, 3, &status);
+    ser_read_frames_parallel(test_ser, frames, 5, PARALLEL_FRAMES - 5, 4, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_frames(frames, 5, PARALLEL_FRAMES - 5);
+
+    /* one thread per CPU */
+    memset(frames, 0, PARALLEL_FRAMES * PARALLEL_FRAME_SIZE);
+    ser_set_parallel_chunk(test_ser, 1, &status);
+    ser_read_frames_parallel(test_ser, frames, 0, PARALLEL_FRAMES, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_frames(frames, 0, PARALLEL_FRAMES);
+
+    free(frames);
+}
+
+START_TEST(parallel_read_file) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_parallel_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    read_parallel(test_ser);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(parallel_read_positional) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_parallel_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    read_parallel(test_ser);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(parallel_read_mapped) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_parallel_ser(filepath, dir);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    read_parallel(test_ser);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(parallel_read_unwritten_appends) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_parallel_ser(filepath, dir);
+    /* <- Setup */
+
+    /* frames still buffered by stdio are read back */
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[PARALLEL_FRAME_SIZE];
+    memset(image_data, PARALLEL_FRAMES + 1, sizeof(image_data));
+    ser_append_frame(test_ser, image_data, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t* frames = (uint8_t*)malloc((PARALLEL_FRAMES + 1) * PARALLEL_FRAME_SIZE);
+    ser_set_parallel_chunk(test_ser, 8, &status);
+    ser_read_frames_parallel(test_ser, frames, 0, PARALLEL_FRAMES + 1, 3, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_frames(frames, 0, PARALLEL_FRAMES + 1);
+    free(frames);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(parallel_read_invalid_range) {
+    int status = 0;
+    uint8_t frames[3 * PARALLEL_FRAME_SIZE];
+    ser_read_frames_parallel(test_ser_3x50, frames, 1, 3, 2, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_IDX);
+
+    status = 0;
+    ser_read_frames_parallel(test_ser_3x50, NULL, 0, 3, 2, &status);
+    ck_assert_int_eq(status, NULL_DEST_BUFF);
+
+    status = 0;
+    ser_read_frames_parallel(test_ser_3x50, frames, 0, 3, 2, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_mem_eq(frames, test_data_3x50.data, sizeof(frames));
+} END_TEST
+
+START_TEST(parallel_read_empty_range) {
+    /* an empty range at a valid frame reads nothing */
+    int status = 0;
+    uint8_t frames[PARALLEL_FRAME_SIZE] = {0};
+    ser_read_frames_parallel(test_ser_3x50, frames, 1, 0, 2, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(frames[0], 0);
+
+    ser_read_frames_parallel(test_ser_3x50, frames, 0, 0, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(frames[0], 0);
+} END_TEST
+
+static void parallel_read_setup() {
+    int status = 0;
+    ser_open_view(
+            &test_ser_3x50,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+}
+
+static void parallel_read_teardown() {
+    int status = 0;
+    ser_close_memory(test_ser_3x50, &status);
+    test_ser_3x50 = NULL;
+}
+
+Suite* parallel_read_suite() {
+    Suite* s;
+    s = suite_create("Parallel Read");
+
+    TCase* tc_parallel_file = tcase_create("parallel_read_file");
+    tcase_add_test(tc_parallel_file, parallel_read_file);
+    tcase_add_test(tc_parallel_file, parallel_read_positional);
+    tcase_add_test(tc_parallel_file, parallel_read_mapped);
+    tcase_add_test(tc_parallel_file, parallel_read_unwritten_appends);
+    suite_add_tcase(s, tc_parallel_file);
+
+    TCase* tc_parallel_memory = tcase_create("parallel_read_memory");
+    tcase_add_checked_fixture(tc_parallel_memory, parallel_read_setup, parallel_read_teardown);
+    tcase_add_test(tc_parallel_memory, parallel_read_invalid_range);
+    tcase_add_test(tc_parallel_memory, parallel_read_empty_range);
+    suite_add_tcase(s, tc_parallel_memory);
+
+    return s;
+}
+
@@ -0,0 +1,161 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+START_TEST(probe_success) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50));
+    /* <- Setup */
+
+    int status = 0;
+    serinfo info;
+    ser_probe(filepath, &info, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ck_assert_mem_eq(info.file_id, test_data_3x50.hdr.file_id, FILEID_LEN);
+    ck_assert_int_eq(info.color_id, BAYER_RGGB);
+    ck_assert_int_eq(info.little_endian, 1);
+    ck_assert_int_eq(info.image_width, 50);
+    ck_assert_int_eq(info.image_height, 50);
+    ck_assert_int_eq(info.pixel_depth_per_plane, 8);
+    ck_assert_int_eq(info.frame_count, 3);
+    ck_assert_mem_eq(info.observer, test_data_3x50.hdr.observer, OBSERVER_LEN);
+    ck_assert_mem_eq(info.instrument, test_data_3x50.hdr.instrument, INSTRUMENT_LEN);
+    ck_assert_mem_eq(info.telescope, test_data_3x50.hdr.telescope, TELESCOPE_LEN);
+    ck_assert_int_eq(info.date_time, TEST_TIMESTAMP_VALUE);
+    ck_assert_int_eq(info.date_time_utc, TEST_TIMESTAMP_VALUE);
+
+    ck_assert_int_eq(info.bytes_per_pixel, 1);
+    ck_assert_int_eq(info.frame_byte_size, 50 * 50);
+    ck_assert_int_eq(info.file_size, sizeof(test_data_3x50));
+    ck_assert(info.has_trailer);
+    ck_assert(info.valid);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(probe_no_trailer) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = test_data_3x50;
+    test_data.hdr.date_time = 0;
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data.hdr) + sizeof(test_data.data));
+    /* <- Setup */
+
+    int status = 0;
+    serinfo info;
+    ser_probe(filepath, &info, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert(!info.has_trailer);
+    ck_assert(info.valid);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(probe_invalid_structure) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, sizeof(test_data_3x50) - 1);
+    /* <- Setup */
+
+    /* the header is still described, the file is flagged invalid */
+    int status = 0;
+    serinfo info;
+    ser_probe(filepath, &info, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(info.frame_count, 3);
+    ck_assert_int_eq(info.file_size, sizeof(test_data_3x50) - 1);
+    ck_assert(!info.has_trailer);
+    ck_assert(!info.valid);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(probe_short_file) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_temp_ser(filepath, dir, &test_data_3x50, HDR_SIZE - 1);
+    /* <- Setup */
+
+    int status = 0;
+    serinfo info;
+    ser_probe(filepath, &info, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(info.file_size, HDR_SIZE - 1);
+    ck_assert_int_eq(info.frame_count, 0);
+    ck_assert(!info.valid);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(probe_file_dne) {
+    int status = 0;
+    serinfo info;
+    ser_probe("/tmp/cserio_test_does_not_exist.ser", &info, &status);
+    ck_assert_int_eq(status, FILE_DNE);
+} END_TEST
+
+START_TEST(probe_null_param) {
+    int status = 0;
+    serinfo info;
+    ser_probe(NULL, &info, &status);
+    ck_assert_int_eq(status, NULL_PATH);
+
+    status = 0;
+    ser_probe("/tmp/cserio_test_does_not_exist.ser", NULL, &status);
+    ck_assert_int_eq(status, NULL_PARAM);
+} END_TEST
+
+Suite* probe_suite() {
+    Suite* s;
+    s = suite_create("Probe");
+
+    TCase* tc_probe = tcase_create("probe");
+    tcase_add_test(tc_probe, probe_success);
+    tcase_add_test(tc_probe, probe_no_trailer);
+    tcase_add_test(tc_probe, probe_invalid_structure);
+    tcase_add_test(tc_probe, probe_short_file);
+    tcase_add_test(tc_probe, probe_file_dne);
+    tcase_add_test(tc_probe, probe_null_param);
+    suite_add_tcase(s, tc_probe);
+
+    return s;
+}
+
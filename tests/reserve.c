@@ -0,0 +1,245 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+START_TEST(reserve_frames_file) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    size_t init_file_size = sizeof(test_data_3x50);
+    create_temp_ser(filepath, dir, &test_data_3x50, init_file_size);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_reserve_frames(test_ser, 400, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* blocks are allocated, the size is untouched */
+    struct stat st;
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, init_file_size);
+    ck_assert_int_ge(st.st_blocks * 512, 400 * 50 * 50);
+
+    uint8_t image_data[50 * 50] = {0};
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* unused reservation is trimmed on close */
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, init_file_size + sizeof(image_data) + sizeof(int64_t));
+    ck_assert_int_lt(st.st_blocks * 512, 400 * 50 * 50);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(reserve_frames_positional) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    size_t init_file_size = sizeof(test_data_3x50);
+    create_temp_ser(filepath, dir, &test_data_3x50, init_file_size);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_positional(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_reserve_frames(test_ser, 400, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    struct stat st;
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, init_file_size);
+    ck_assert_int_ge(st.st_blocks * 512, 400 * 50 * 50);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, init_file_size);
+    ck_assert_int_lt(st.st_blocks * 512, 400 * 50 * 50);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(reserve_frames_mapped) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    size_t init_file_size = sizeof(test_data_3x50);
+    create_temp_ser(filepath, dir, &test_data_3x50, init_file_size);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file_mapped(&test_ser, filepath, READWRITE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_reserve_frames(test_ser, 400, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    uint8_t image_data[50 * 50];
+    memset(image_data, 0xA0, sizeof(image_data));
+    ser_append_frame(test_ser, image_data, TEST_TIMESTAMP_VALUE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    struct stat st;
+    ck_assert_int_eq(stat(filepath, &st), 0);
+    ck_assert_int_eq(st.st_size, init_file_size + sizeof(image_data) + sizeof(int64_t));
+    ck_assert_int_lt(st.st_blocks * 512, 400 * 50 * 50);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(reserve_frames_memory) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_write_image_width(test_ser, 50, &status);
+    ser_write_image_height(test_ser, 50, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_reserve_frames(test_ser, 10, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* appends land in the reserved buffer, borrowed pointers stay valid */
+    uint8_t image_data[50 * 50];
+    memset(image_data, 0xA0, sizeof(image_data));
+    ser_append_frame(test_ser, image_data, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    const void* first = NULL;
+    ser_get_frame_ptr(test_ser, 0, &first, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    for (int i = 1; i < 10; i++) {
+        ser_append_frame(test_ser, image_data, 0, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    const void* again = NULL;
+    ser_get_frame_ptr(test_ser, 0, &again, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_ptr_eq(first, again);
+    ck_assert_mem_eq(again, image_data, sizeof(image_data));
+
+    ser_close_memory(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+} END_TEST
+
+START_TEST(reserve_frames_not_supported) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_view(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READWRITE,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_reserve_frames(test_ser, 10, &status);
+    ck_assert_int_eq(status, NOT_SUPPORTED);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+START_TEST(reserve_frames_readonly) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_memory(
+            &test_ser,
+            (uint8_t*)&test_data_3x50,
+            sizeof(test_data_3x50),
+            READONLY,
+            &status
+    );
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_reserve_frames(test_ser, 10, &status);
+    ck_assert_int_eq(status, WRITE_ON_READONLY);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+START_TEST(reserve_frames_invalid_frame_size) {
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_create_memory(&test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    ser_reserve_frames(test_ser, 10, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_SIZE);
+
+    status = 0;
+    ser_close_memory(test_ser, &status);
+} END_TEST
+
+Suite* reserve_suite() {
+    Suite* s;
+    s = suite_create("Reserve");
+
+    TCase* tc_reserve_file = tcase_create("reserve_file");
+    tcase_add_test(tc_reserve_file, reserve_frames_file);
+    tcase_add_test(tc_reserve_file, reserve_frames_positional);
+    tcase_add_test(tc_reserve_file, reserve_frames_mapped);
+    suite_add_tcase(s, tc_reserve_file);
+
+    TCase* tc_reserve_memory = tcase_create("reserve_memory");
+    tcase_add_test(tc_reserve_memory, reserve_frames_memory);
+    tcase_add_test(tc_reserve_memory, reserve_frames_not_supported);
+    tcase_add_test(tc_reserve_memory, reserve_frames_readonly);
+    tcase_add_test(tc_reserve_memory, reserve_frames_invalid_frame_size);
+    suite_add_tcase(s, tc_reserve_memory);
+
+    return s;
+}
+
@@ -0,0 +1,256 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+#define ROLLOVER_FRAME_SIZE (50 * 50)
+
+static void part_path(char* path, const char* dir, int part) {
+    if (part) {
+        snprintf(path, 512, "%s/night.%04d.ser", dir, part);
+    } else {
+        snprintf(path, 512, "%s/night.manifest", dir);
+    }
+}
+
+static void destroy_temp_dir(char* dir, int parts) {
+    char path[512];
+    for (int part = 0; part <= parts; part++) {
+        part_path(path, dir, part);
+        unlink(path);
+    }
+    rmdir(dir);
+}
+
+static void make_header(serinfo* header) {
+    memset(header, 0, sizeof(serinfo));
+    memcpy(header->file_id, test_data_3x50.hdr.file_id, FILEID_LEN);
+    header->color_id = MONO;
+    header->little_endian = LITTLEENDIAN_TRUE;
+    header->image_width = 50;
+    header->image_height = 50;
+    header->pixel_depth_per_plane = 8;
+    memcpy(header->observer, test_data_3x50.hdr.observer, OBSERVER_LEN);
+    header->date_time = TEST_TIMESTAMP_VALUE + 1000;
+    header->date_time_utc = TEST_TIMESTAMP_VALUE;
+}
+
+/* frame i is filled with i + 1 and stamped TEST_TIMESTAMP_VALUE + 10 * i */
+static void append_frames(serrollover* rollover, int frames) {
+    uint8_t image_data[ROLLOVER_FRAME_SIZE];
+    for (int i = 0; i < frames; i++) {
+        int status = 0;
+        memset(image_data, i + 1, sizeof(image_data));
+        ser_rollover_append(rollover, image_data, TEST_TIMESTAMP_VALUE + 10 * i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+}
+
+static void check_part(const char* dir, int part, int first, int frames) {
+    char path[512];
+    part_path(path, dir, part);
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, path, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, frames);
+
+    char observer[OBSERVER_LEN];
+    ser_read_observer(test_ser, observer, &status);
+    ck_assert_mem_eq(observer, test_data_3x50.hdr.observer, OBSERVER_LEN);
+
+    /* the header time follows the first frame of the part */
+    int64_t date_time = 0;
+    int64_t date_time_utc = 0;
+    ser_read_date_time(test_ser, &date_time, &status);
+    ser_read_date_time_utc(test_ser, &date_time_utc, &status);
+    ck_assert_int_eq(date_time_utc, TEST_TIMESTAMP_VALUE + 10 * first);
+    ck_assert_int_eq(date_time, TEST_TIMESTAMP_VALUE + 10 * first + 1000);
+
+    uint8_t buffer[ROLLOVER_FRAME_SIZE];
+    for (int i = 0; i < frames; i++) {
+        ser_read_frame(test_ser, buffer, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(buffer[0], first + i + 1);
+
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + 10 * (first + i));
+    }
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+}
+
+START_TEST(rollover_frame_limit) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    char path[512];
+    snprintf(path, 512, "%s/night.ser", dir);
+    /* <- Setup */
+
+    serinfo header;
+    make_header(&header);
+
+    int status = 0;
+    serrollover* rollover = NULL;
+    ser_rollover_create(&rollover, path, &header, 0, 4, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    append_frames(rollover, 10);
+    ser_rollover_close(rollover, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    check_part(dir, 1, 0, 4);
+    check_part(dir, 2, 4, 4);
+    check_part(dir, 3, 8, 2);
+
+    char manifest_path[512];
+    part_path(manifest_path, dir, 0);
+    FILE* manifest = fopen(manifest_path, "r");
+    ck_assert_ptr_nonnull(manifest);
+    char contents[256] = {0};
+    ck_assert_uint_gt(fread(contents, 1, sizeof(contents) - 1, manifest), 0);
+    fclose(manifest);
+    ck_assert_str_eq(
+            contents,
+            "# cserio rollover manifest\n"
+            "night.0001.ser 0 4\n"
+            "night.0002.ser 4 4\n"
+            "night.0003.ser 8 2\n"
+    );
+
+    /* Teardown -> */
+    destroy_temp_dir(dir, 3);
+} END_TEST
+
+START_TEST(rollover_byte_limit) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    char path[512];
+    snprintf(path, 512, "%s/night", dir);
+    /* <- Setup */
+
+    serinfo header;
+    make_header(&header);
+
+    /* room for three frames and their timestamps */
+    uint64_t max_bytes = HDR_SIZE + 3 * (ROLLOVER_FRAME_SIZE + sizeof(int64_t)) + 10;
+
+    int status = 0;
+    serrollover* rollover = NULL;
+    ser_rollover_create(&rollover, path, &header, max_bytes, 0, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    append_frames(rollover, 7);
+    ser_rollover_close(rollover, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    check_part(dir, 1, 0, 3);
+    check_part(dir, 2, 3, 3);
+    check_part(dir, 3, 6, 1);
+
+    for (int part = 1; part <= 3; part++) {
+        char part_file[512];
+        part_path(part_file, dir, part);
+        struct stat st;
+        ck_assert_int_eq(stat(part_file, &st), 0);
+        ck_assert_uint_le((uint64_t)st.st_size, max_bytes);
+    }
+
+    /* Teardown -> */
+    destroy_temp_dir(dir, 3);
+} END_TEST
+
+START_TEST(rollover_existing_part) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    char path[512];
+    snprintf(path, 512, "%s/night.ser", dir);
+    char first_part[512];
+    part_path(first_part, dir, 1);
+    FILE* existing = fopen(first_part, "w");
+    fclose(existing);
+    /* <- Setup */
+
+    serinfo header;
+    make_header(&header);
+
+    int status = 0;
+    serrollover* rollover = NULL;
+    ser_rollover_create(&rollover, path, &header, 0, 4, &status);
+    ck_assert_int_eq(status, FILE_EXISTS);
+    ck_assert_ptr_null(rollover);
+
+    /* the existing file is left alone */
+    struct stat st;
+    ck_assert_int_eq(stat(first_part, &st), 0);
+
+    /* Teardown -> */
+    destroy_temp_dir(dir, 1);
+} END_TEST
+
+START_TEST(rollover_invalid_header) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    char path[512];
+    snprintf(path, 512, "%s/night.ser", dir);
+    /* <- Setup */
+
+    serinfo header;
+    make_header(&header);
+    header.image_width = 0;
+
+    int status = 0;
+    serrollover* rollover = NULL;
+    ser_rollover_create(&rollover, path, &header, 0, 4, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_SIZE);
+    ck_assert_ptr_null(rollover);
+
+    /* nothing is left behind */
+    char first_part[512];
+    part_path(first_part, dir, 1);
+    struct stat st;
+    ck_assert_int_ne(stat(first_part, &st), 0);
+
+    status = 0;
+    ser_rollover_create(&rollover, NULL, &header, 0, 4, &status);
+    ck_assert_int_eq(status, NULL_PATH);
+
+    /* Teardown -> */
+    destroy_temp_dir(dir, 1);
+} END_TEST
+
+Suite* rollover_suite() {
+    Suite* s;
+    s = suite_create("Rollover");
+
+    TCase* tc_rollover = tcase_create("rollover");
+    tcase_add_test(tc_rollover, rollover_frame_limit);
+    tcase_add_test(tc_rollover, rollover_byte_limit);
+    tcase_add_test(tc_rollover, rollover_existing_part);
+    tcase_add_test(tc_rollover, rollover_invalid_header);
+    suite_add_tcase(s, tc_rollover);
+
+    return s;
+}
+
@@ -0,0 +1,366 @@
+#include "suites.h"
+
+#include <check.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "ser_test_data.h"
+
+#include "../cserio.h"
+
+
+static void create_temp_ser(char* filepath, char* dir, void* data, size_t size) {
+    if (!mkdtemp(dir)) {
+        ck_abort_msg("Failed to make temp directory");
+    }
+    snprintf(filepath, 512, "%s/cserio_test_file.ser", dir);
+
+    FILE* file = fopen(filepath, "w+b");
+    if (!file) {
+        ck_abort_msg("Test Init Failure: Failed to make test file");
+    }
+
+    fwrite(data, 1, size, file);
+    fseek(file, 0, SEEK_END);
+    long file_size = ftell(file);
+    ck_assert_int_eq(file_size, size);
+
+    fclose(file);
+    return;
+}
+
+static void destroy_temp_ser(char* filepath, char* dir) {
+    unlink(filepath);
+    rmdir(dir);
+}
+
+/* frame i is filled with i + 1, timestamp i is TEST_TIMESTAMP_VALUE + i */
+static SERTest3x50Structure salvage_data(void) {
+    SERTest3x50Structure test_data = test_data_3x50;
+    for (int i = 0; i < 3; i++) {
+        memset(test_data.data + i * 50 * 50, i + 1, 50 * 50);
+        test_data.trlr[i] = TEST_TIMESTAMP_VALUE + i;
+    }
+    return test_data;
+}
+
+static void check_salvaged_frames(serfile* test_ser, int32_t expected) {
+    int status = 0;
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, expected);
+
+    uint8_t buffer[50 * 50];
+    for (int i = 0; i < expected; i++) {
+        ser_read_frame(test_ser, buffer, i, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(buffer[0], i + 1);
+        ck_assert_int_eq(buffer[sizeof(buffer) - 1], i + 1);
+    }
+
+    ser_read_frame(test_ser, buffer, expected, &status);
+    ck_assert_int_eq(status, INVALID_FRAME_IDX);
+}
+
+START_TEST(salvage_partial_frame) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = salvage_data();
+    test_data.hdr.date_time = 0;
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data.hdr) + sizeof(test_data.data));
+    ck_assert_int_eq(truncate(filepath, sizeof(test_data.hdr) + sizeof(test_data.data) - 1000), 0);
+    /* <- Setup */
+
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, INVALID_STRUCTURE);
+
+    status = 0;
+    ser_open_file(&test_ser, filepath, READSALVAGE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_salvaged_frames(test_ser, 2);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 0, &status);
+    ck_assert_int_eq(status, TRAILER_DNE);
+
+    /* salvaged handles are read only */
+    status = 0;
+    uint8_t image_data[50 * 50] = {0};
+    ser_append_frame(test_ser, image_data, 0, &status);
+    ck_assert_int_eq(status, WRITE_ON_READONLY);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(salvage_partial_trailer) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = salvage_data();
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data) - 4);
+    /* <- Setup */
+
+    int (*opener[])(serfile**, const char*, int, int*) = {
+        ser_open_file,
+        ser_open_file_positional,
+        ser_open_file_mapped
+    };
+    for (int i = 0; i < 3; i++) {
+        int status = 0;
+        serfile* test_ser = NULL;
+        opener[i](&test_ser, filepath, READSALVAGE, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        check_salvaged_frames(test_ser, 3);
+
+        /* the last timestamp was cut short */
+        int64_t timestamp = 0;
+        ser_read_timestamp(test_ser, &timestamp, 1, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+        ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + 1);
+
+        ser_read_timestamp(test_ser, &timestamp, 2, &status);
+        ck_assert_int_eq(status, INVALID_TRAILER_IDX);
+
+        status = 0;
+        ser_close_file(test_ser, &status);
+        ck_assert_int_eq(status, NO_ERROR);
+    }
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(salvage_stale_header) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = salvage_data();
+    test_data.hdr.frame_count = 1;
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data.hdr) + sizeof(test_data.data) - 10);
+    /* <- Setup */
+
+    /* two frames and part of a third were appended past the header */
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READSALVAGE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_salvaged_frames(test_ser, 2);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 0, &status);
+    ck_assert_int_eq(status, INVALID_TRAILER_IDX);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(salvage_repair) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = salvage_data();
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data) - 4);
+    /* <- Setup */
+
+    int status = 0;
+    ser_repair_file(filepath, NULL, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    serinfo info;
+    ser_probe(filepath, &info, &status);
+    ck_assert(info.valid);
+    ck_assert(info.has_trailer);
+    ck_assert_int_eq(info.file_size, sizeof(test_data));
+
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READONLY, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    check_salvaged_frames(test_ser, 3);
+
+    /* the timestamp that was lost is written as 0 */
+    int64_t timestamp = -1;
+    ser_read_timestamp(test_ser, &timestamp, 1, &status);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + 1);
+    ser_read_timestamp(test_ser, &timestamp, 2, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, 0);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(salvage_repair_stale_header) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = salvage_data();
+    test_data.hdr.date_time = 0;
+    test_data.hdr.frame_count = 0;
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data.hdr) + sizeof(test_data.data) - 10);
+    /* <- Setup */
+
+    int status = 0;
+    ser_repair_file(filepath, NULL, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    serinfo info;
+    ser_probe(filepath, &info, &status);
+    ck_assert(info.valid);
+    ck_assert(!info.has_trailer);
+    ck_assert_int_eq(info.frame_count, 2);
+    ck_assert_int_eq(info.file_size, sizeof(test_data.hdr) + 2 * 50 * 50);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+/* writes a 2x2 SER with frames_on_disk frames, frame i filled with 
+ * i % 8, whose header counts frame_count, followed by trailer */
+static void create_small_frame_ser(char* filepath, char* dir, int32_t frame_count, int frames_on_disk,
+        const int64_t* trailer, int trailer_count) {
+    SERHdrStructure hdr = test_data_3x50.hdr;
+    hdr.image_width = 2;
+    hdr.image_height = 2;
+    hdr.frame_count = frame_count;
+
+    uint8_t data[sizeof(hdr) + 64 * 4 + 64 * sizeof(int64_t)];
+    size_t size = sizeof(hdr);
+    memcpy(data, &hdr, sizeof(hdr));
+    for (int i = 0; i < frames_on_disk; i++) {
+        memset(data + size, i % 8, 4);
+        size += 4;
+    }
+    if (trailer_count) {
+        memcpy(data + size, trailer, trailer_count * sizeof(int64_t));
+        size += trailer_count * sizeof(int64_t);
+    }
+
+    create_temp_ser(filepath, dir, data, size);
+}
+
+START_TEST(salvage_stale_header_small_frames) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    create_small_frame_ser(filepath, dir, 10, 14, NULL, 0);
+    /* <- Setup */
+
+    /* the 4 frames past the header would fit in its trailer */
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READSALVAGE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 14);
+
+    uint8_t buffer[4];
+    ser_read_frame(test_ser, buffer, 13, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(buffer[0], 13 % 8);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 0, &status);
+    ck_assert_int_eq(status, INVALID_TRAILER_IDX);
+
+    status = 0;
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* repair keeps them as frames */
+    ser_repair_file(filepath, NULL, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    serinfo info;
+    ser_probe(filepath, &info, &status);
+    ck_assert(info.valid);
+    ck_assert_int_eq(info.frame_count, 14);
+    ck_assert_int_eq(info.file_size, HDR_SIZE + 14 * (4 + sizeof(int64_t)));
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(salvage_small_frame_trailer) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    int64_t trailer[10];
+    for (int i = 0; i < 10; i++) {
+        trailer[i] = TEST_TIMESTAMP_VALUE + i;
+    }
+    create_small_frame_ser(filepath, dir, 10, 10, trailer, 10);
+    /* <- Setup */
+
+    /* a real trailer holds whole frames too, but reads as timestamps */
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READSALVAGE, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    int32_t frame_count = 0;
+    ser_read_frame_count(test_ser, &frame_count, &status);
+    ck_assert_int_eq(frame_count, 10);
+
+    int64_t timestamp = 0;
+    ser_read_timestamp(test_ser, &timestamp, 9, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+    ck_assert_int_eq(timestamp, TEST_TIMESTAMP_VALUE + 9);
+
+    ser_close_file(test_ser, &status);
+    ck_assert_int_eq(status, NO_ERROR);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+START_TEST(salvage_invalid_header) {
+    char dir[] = "/tmp/cserio_testXXXXXX";
+    char filepath[512];
+    SERTest3x50Structure test_data = salvage_data();
+    test_data.hdr.image_width = 0;
+    create_temp_ser(filepath, dir, &test_data, sizeof(test_data) - 4);
+    /* <- Setup */
+
+    /* nothing can be inferred without a frame size */
+    int status = 0;
+    serfile* test_ser = NULL;
+    ser_open_file(&test_ser, filepath, READSALVAGE, &status);
+    ck_assert_int_eq(status, INVALID_STRUCTURE);
+    ck_assert_ptr_null(test_ser);
+
+    status = 0;
+    ser_repair_file(filepath, NULL, &status);
+    ck_assert_int_eq(status, INVALID_STRUCTURE);
+
+    /* Teardown -> */
+    destroy_temp_ser(filepath, dir);
+} END_TEST
+
+Suite* salvage_suite() {
+    Suite* s;
+    s = suite_create("Salvage");
+
+    TCase* tc_salvage = tcase_create("salvage");
+    tcase_add_test(tc_salvage, salvage_partial_frame);
+    tcase_add_test(tc_salvage, salvage_partial_trailer);
+    tcase_add_test(tc_salvage, salvage_stale_header);
+    tcase_add_test(tc_salvage, salvage_repair);
+    tcase_add_test(tc_salvage, salvage_repair_stale_header);
+    tcase_add_test(tc_salvage, salvage_stale_header_small_frames);
+    tcase_add_test(tc_salvage, salvage_small_frame_trailer);
+    tcase_add_test(tc_salvage, salvage_invalid_header);
+    suite_add_tcase(s, tc_salvage);
+
+    return s;
+}
+
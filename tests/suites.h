@@ -2,8 +2,17 @@
 #ifndef SUITES_H
 #define SUITES_H
 
+/* the tests use POSIX helpers such as mkdtemp and usleep */
+#if !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <check.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 Suite* core_suite();
 
 Suite* create_memory_suite();
@@ -11,6 +20,14 @@ Suite* open_view_suite();
 Suite* open_memory_suite();
 Suite* create_file_suite();
 Suite* open_file_suite();
+Suite* open_mapped_suite();
+Suite* open_positional_suite();
+Suite* open_custom_suite();
+Suite* direct_io_suite();
+Suite* probe_suite();
+Suite* clone_suite();
+Suite* follow_suite();
+Suite* salvage_suite();
 
 Suite* header_read_suite();
 Suite* header_write_suite();
@@ -18,9 +35,26 @@ Suite* header_write_suite();
 Suite* image_info_suite();
 Suite* image_read_suite();
 Suite* image_write_suite();
+Suite* reserve_suite();
+Suite* capacity_suite();
+Suite* async_read_suite();
+Suite* parallel_read_suite();
+Suite* for_each_suite();
+Suite* access_hint_suite();
+Suite* commit_suite();
+Suite* journal_suite();
+Suite* capture_suite();
+Suite* async_append_suite();
+Suite* rollover_suite();
+Suite* coroutine_suite();
+Suite* large_file_suite();
 
 Suite* trailer_read_suite();
 
+#ifdef __cplusplus
+}
+#endif
+
 
 #endif
 